@@ -0,0 +1,223 @@
+const std = @import("std");
+const zen = @import("zen");
+
+// Benchmark harness for the compiler's front-end stages, run via
+// `zig build bench`. Each workload is a parameterized synthetic .zen
+// source built in memory; each stage (lex, parse, check) runs in
+// isolation against it with its inputs prepared outside the timed
+// region, and the best of several repetitions after warmup is reported
+// as MB/s (and tokens/s for the lexer). Performance changes to the
+// lexer, parser, or checker should land with numbers from here.
+//
+// Code generation is not benchmarked: generateProgram writes output
+// files and initializes native targets, so it is better measured
+// end-to-end with `zenc --time-report`.
+
+const warmup_runs = 2;
+const timed_runs = 5;
+
+pub fn main() !void {
+    var gpa = std.heap.GeneralPurposeAllocator(.{}){};
+    defer _ = gpa.deinit();
+    const allocator = gpa.allocator();
+
+    std.debug.print("zen-bench ({s}), warmup {d}, best of {d}\n", .{ zen.version(), warmup_runs, timed_runs });
+
+    {
+        const source = try manyFunctions(allocator, 2000);
+        defer allocator.free(source);
+        try benchWorkload(allocator, "many-functions(2000)", source);
+    }
+    {
+        const source = try deepNesting(allocator, 200);
+        defer allocator.free(source);
+        try benchWorkload(allocator, "deep-nesting(200)", source);
+    }
+    {
+        const source = try identifierHeavy(allocator, 5000);
+        defer allocator.free(source);
+        try benchWorkload(allocator, "identifier-heavy(5000)", source);
+    }
+    {
+        const source = try commentHeavy(allocator, 10000);
+        defer allocator.free(source);
+        try benchWorkload(allocator, "comment-heavy(10000)", source);
+    }
+}
+
+fn benchWorkload(allocator: std.mem.Allocator, name: []const u8, source: []const u8) !void {
+    std.debug.print("\n{s}: {d} bytes\n", .{ name, source.len });
+
+    // Lex: interner and token buffer are rebuilt every run; that is the
+    // stage's real cost.
+    var token_count: u64 = 0;
+    const lex_ns = try bestOf(struct {
+        allocator: std.mem.Allocator,
+        source: []const u8,
+        token_count: *u64,
+
+        fn run(ctx: @This()) !void {
+            var interner = zen.intern.StringInterner.init(ctx.allocator);
+            defer interner.deinit();
+            var tokenizer = zen.lexer.Lexer.init(ctx.allocator, ctx.source, &interner);
+            defer tokenizer.deinit();
+            var tokens = try tokenizer.tokenize();
+            defer tokens.deinit(ctx.allocator);
+            ctx.token_count.* = tokens.len();
+        }
+    }{ .allocator = allocator, .source = source, .token_count = &token_count });
+    reportStage("lex", source.len, lex_ns, token_count);
+
+    // Parse: tokens are materialized once outside the timed region; each
+    // run parses into a fresh arena, so arena allocation is counted.
+    var interner = zen.intern.StringInterner.init(allocator);
+    defer interner.deinit();
+    var tokenizer = zen.lexer.Lexer.init(allocator, source, &interner);
+    defer tokenizer.deinit();
+    var tokens = try tokenizer.tokenize();
+    defer tokens.deinit(allocator);
+
+    const parse_ns = try bestOf(struct {
+        allocator: std.mem.Allocator,
+        tokens: zen.lexer.TokenBuffer,
+
+        fn run(ctx: @This()) !void {
+            var arena = zen.ast.AstArena.init(ctx.allocator);
+            defer arena.deinit();
+            var parser = zen.parser.Parser.init(arena.allocator(), ctx.tokens);
+            defer parser.deinit();
+            _ = try parser.parseProgram();
+        }
+    }{ .allocator = allocator, .tokens = tokens });
+    reportStage("parse", source.len, parse_ns, 0);
+
+    // Check: the tree is built once outside the timed region; each run is
+    // a fresh TypeChecker over the same tree.
+    var arena = zen.ast.AstArena.init(allocator);
+    defer arena.deinit();
+    var parser = zen.parser.Parser.init(arena.allocator(), tokens);
+    defer parser.deinit();
+    var tree = try parser.parseProgram();
+
+    const check_ns = try bestOf(struct {
+        allocator: std.mem.Allocator,
+        interner: *zen.intern.StringInterner,
+        tree: *zen.ast.Ast,
+
+        fn run(ctx: @This()) !void {
+            var type_checker = zen.checker.TypeChecker.init(ctx.allocator, ctx.interner);
+            defer type_checker.deinit();
+            try type_checker.checkProgram(ctx.tree);
+        }
+    }{ .allocator = allocator, .interner = &interner, .tree = &tree });
+    reportStage("check", source.len, check_ns, 0);
+}
+
+// Runs ctx.run() warmup_runs times untimed, then timed_runs times, and
+// returns the fastest observation: minimum filters scheduler noise
+// better than the mean for short single-threaded regions.
+fn bestOf(ctx: anytype) !u64 {
+    for (0..warmup_runs) |_| try ctx.run();
+
+    var best: u64 = std.math.maxInt(u64);
+    for (0..timed_runs) |_| {
+        var timer = try std.time.Timer.start();
+        try ctx.run();
+        best = @min(best, timer.read());
+    }
+    return best;
+}
+
+fn reportStage(stage: []const u8, bytes: usize, ns: u64, tokens: u64) void {
+    const seconds = @as(f64, @floatFromInt(ns)) / std.time.ns_per_s;
+    const mb_per_s = @as(f64, @floatFromInt(bytes)) / (1024.0 * 1024.0) / seconds;
+    if (tokens != 0) {
+        const tokens_per_s = @as(f64, @floatFromInt(tokens)) / seconds;
+        std.debug.print("  {s:<6} {d:>10} ns  {d:>8.1} MB/s  {d:>12.0} tokens/s\n", .{ stage, ns, mb_per_s, tokens_per_s });
+    } else {
+        std.debug.print("  {s:<6} {d:>10} ns  {d:>8.1} MB/s\n", .{ stage, ns, mb_per_s });
+    }
+}
+
+// --- Synthetic source generators -------------------------------------------
+
+// Many small functions plus a main that calls the first few: stresses
+// declaration collection, the two-pass checker, and symbol interning at
+// function granularity.
+fn manyFunctions(allocator: std.mem.Allocator, count: usize) ![]u8 {
+    var source = std.ArrayList(u8){};
+    errdefer source.deinit(allocator);
+
+    for (0..count) |i| {
+        try appendFmt(&source, allocator,
+            \\fn helper_{d}(a: i32, b: i32) -> i32 {{
+            \\    const scaled = a * {d};
+            \\    return scaled + b;
+            \\}}
+            \\
+            \\
+        , .{ i, i + 1 });
+    }
+    try appendFmt(&source, allocator, "fn main() -> i32 {{\n", .{});
+    for (0..@min(count, 16)) |i| {
+        try appendFmt(&source, allocator, "    print_int(helper_{d}({d}, {d}));\n", .{ i, i, i + 1 });
+    }
+    try appendFmt(&source, allocator, "    return 0;\n}}\n", .{});
+
+    return source.toOwnedSlice(allocator);
+}
+
+// One function whose return expression nests `depth` levels deep:
+// stresses recursive-descent depth and precedence climbing.
+fn deepNesting(allocator: std.mem.Allocator, depth: usize) ![]u8 {
+    var source = std.ArrayList(u8){};
+    errdefer source.deinit(allocator);
+
+    try appendFmt(&source, allocator, "fn main() -> i32 {{\n    const result = ", .{});
+    for (0..depth) |_| {
+        try source.appendSlice(allocator, "(1 + ");
+    }
+    try source.appendSlice(allocator, "1");
+    for (0..depth) |_| {
+        try source.appendSlice(allocator, ") * 2");
+    }
+    try appendFmt(&source, allocator, ";\n    print_int(result);\n    return 0;\n}}\n", .{});
+
+    return source.toOwnedSlice(allocator);
+}
+
+// A long run of declarations with distinct long identifiers: stresses
+// interner hashing and the scope stack's backward scan.
+fn identifierHeavy(allocator: std.mem.Allocator, count: usize) ![]u8 {
+    var source = std.ArrayList(u8){};
+    errdefer source.deinit(allocator);
+
+    try appendFmt(&source, allocator, "fn main() -> i32 {{\n    const seed_value_for_benchmark_0 = 1;\n", .{});
+    for (1..count) |i| {
+        try appendFmt(&source, allocator, "    const seed_value_for_benchmark_{d} = seed_value_for_benchmark_{d} + {d};\n", .{ i, i - 1, i });
+    }
+    try appendFmt(&source, allocator, "    print_int(seed_value_for_benchmark_{d});\n    return 0;\n}}\n", .{count - 1});
+
+    return source.toOwnedSlice(allocator);
+}
+
+// Mostly comment lines around a tiny program: stresses the lexer's skip
+// path, which dominates on documentation-heavy real sources.
+fn commentHeavy(allocator: std.mem.Allocator, lines: usize) ![]u8 {
+    var source = std.ArrayList(u8){};
+    errdefer source.deinit(allocator);
+
+    try appendFmt(&source, allocator, "fn main() -> i32 {{\n", .{});
+    for (0..lines) |i| {
+        try appendFmt(&source, allocator, "    // comment line {d}: the quick brown fox jumps over the lazy dog\n", .{i});
+    }
+    try appendFmt(&source, allocator, "    return 0;\n}}\n", .{});
+
+    return source.toOwnedSlice(allocator);
+}
+
+fn appendFmt(source: *std.ArrayList(u8), allocator: std.mem.Allocator, comptime fmt: []const u8, args: anytype) !void {
+    const text = try std.fmt.allocPrint(allocator, fmt, args);
+    defer allocator.free(text);
+    try source.appendSlice(allocator, text);
+}
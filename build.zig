@@ -37,6 +37,75 @@ pub fn build(b: *std.Build) void {
         run_cmd.addArgs(args);
     }
 
+    // Benchmark step: front-end stage benchmarks over synthetic sources,
+    // built on the library exports in root.zig.
+    const zen_module = b.addModule("zen", .{
+        .root_source_file = b.path("src/root.zig"),
+        .target = target,
+        .optimize = optimize,
+    });
+    zen_module.addImport("llvm", llvm_mod);
+
+    const bench_module = b.addModule("zen-bench", .{
+        .root_source_file = b.path("bench/main.zig"),
+        .target = target,
+        .optimize = optimize,
+    });
+    bench_module.addImport("zen", zen_module);
+
+    const bench_exe = b.addExecutable(.{
+        .name = "zen-bench",
+        .root_module = bench_module,
+    });
+
+    const run_bench = b.addRunArtifact(bench_exe);
+    const bench_step = b.step("bench", "Run compiler benchmarks");
+    bench_step.dependOn(&run_bench.step);
+
+    // Release pipeline: the shipping zenc is always ReleaseFast with LTO
+    // across the compiler and the LLVM bindings, independent of whatever
+    // -Doptimize the developer build above was invoked with.
+    const release_optimize: std.builtin.OptimizeMode = .ReleaseFast;
+    const release_llvm_dep = b.dependency("llvm", .{
+        .target = target,
+        .optimize = release_optimize,
+    });
+
+    const release_module = b.addModule("zen-release", .{
+        .root_source_file = b.path("src/main.zig"),
+        .target = target,
+        .optimize = release_optimize,
+    });
+    release_module.addImport("llvm", release_llvm_dep.module("llvm"));
+
+    const release_exe = b.addExecutable(.{
+        .name = "zenc",
+        .root_module = release_module,
+    });
+    release_exe.want_lto = true;
+
+    const release_step = b.step("release", "Build zenc as ReleaseFast with LTO");
+    release_step.dependOn(&b.addInstallArtifact(release_exe, .{}).step);
+
+    // Corpus runs for the release binary: front-end every example with the
+    // freshly built zenc. Zig does not expose profile-generate/profile-use
+    // for Zig code yet, so this is the harness a PGO pass would hang its
+    // training runs on rather than PGO itself; until then it doubles as a
+    // smoke test of the shipping configuration.
+    const train_step = b.step("release-train", "Run the release zenc over the example corpus");
+    const corpus = [_][]const u8{
+        "examples/arithmetic.zen",
+        "examples/fibonacci.zen",
+        "examples/hello.zen",
+        "examples/test.zen",
+    };
+    for (corpus) |example| {
+        const train_run = b.addRunArtifact(release_exe);
+        train_run.addArg("--check");
+        train_run.addFileArg(b.path(example));
+        train_step.dependOn(&train_run.step);
+    }
+
     // Test step
     const test_module = b.addModule("zen-test", .{
         .root_source_file = b.path("src/main.zig"),
@@ -1,5 +1,6 @@
 const std = @import("std");
 const types = @import("types.zig");
+const intern = @import("intern.zig");
 
 pub const Position = struct {
     line: u32,
@@ -15,6 +16,7 @@ pub const NodeType = enum {
     expression_statement,
     if_statement,
     while_statement,
+    for_statement,
     assignment_expression,
     binary_expression,
     unary_expression,
@@ -25,6 +27,20 @@ pub const NodeType = enum {
     boolean_literal,
 };
 
+// Nodes live contiguously in Ast.nodes and reference children by index, so
+// traversal walks a dense array instead of chasing heap pointers.
+pub const NodeIndex = u32;
+
+// Sentinel for absent optional children (a return without a value, an if
+// without an else, a declaration without an initializer).
+pub const null_node: NodeIndex = std.math.maxInt(NodeIndex);
+
+// Range into Ast.extra holding a variable-length child list.
+pub const ExtraRange = struct {
+    start: u32,
+    len: u32,
+};
+
 pub const Node = struct {
     node_type: NodeType,
     position: Position,
@@ -39,6 +55,7 @@ pub const Node = struct {
         expression_statement: ExpressionStatement,
         if_statement: IfStatement,
         while_statement: WhileStatement,
+        for_statement: ForStatement,
         assignment_expression: AssignmentExpression,
         binary_expression: BinaryExpression,
         unary_expression: UnaryExpression,
@@ -51,54 +68,68 @@ pub const Node = struct {
 };
 
 pub const Program = struct {
-    statements: []*Node,
+    statements: ExtraRange,
 };
 
 pub const FunctionDeclaration = struct {
     name: []const u8,
+    symbol: intern.Symbol,
     parameters: []Parameter,
     return_type: types.Type,
-    body: *Node, // BlockStatement
+    body: NodeIndex, // BlockStatement
 };
 
 pub const Parameter = struct {
     name: []const u8,
+    symbol: intern.Symbol,
     param_type: types.Type,
 };
 
 pub const VariableDeclaration = struct {
     name: []const u8,
+    symbol: intern.Symbol,
     var_type: ?types.Type, // null for type inference
     is_mutable: bool, // let vs const
-    initializer: ?*Node,
+    initializer: NodeIndex, // null_node if absent
 };
 
 pub const BlockStatement = struct {
-    statements: []*Node,
+    statements: ExtraRange,
 };
 
 pub const ReturnStatement = struct {
-    value: ?*Node,
+    value: NodeIndex, // null_node for bare `return;`
 };
 
 pub const ExpressionStatement = struct {
-    expression: *Node,
+    expression: NodeIndex,
 };
 
 pub const IfStatement = struct {
-    condition: *Node,
-    then_branch: *Node,
-    else_branch: ?*Node,
+    condition: NodeIndex,
+    then_branch: NodeIndex,
+    else_branch: NodeIndex, // null_node if absent
 };
 
 pub const WhileStatement = struct {
-    condition: *Node,
-    body: *Node,
+    condition: NodeIndex,
+    body: NodeIndex,
+};
+
+// Ranged `for i in start..end` loop. The bounds are arbitrary i32
+// expressions, evaluated once before the first iteration; `end` is
+// exclusive.
+pub const ForStatement = struct {
+    name: []const u8,
+    symbol: intern.Symbol,
+    start: NodeIndex,
+    end: NodeIndex,
+    body: NodeIndex, // BlockStatement
 };
 
 pub const AssignmentExpression = struct {
-    target: *Node, // Identifier
-    value: *Node,
+    target: NodeIndex, // Identifier
+    value: NodeIndex,
 };
 
 pub const BinaryOperator = enum {
@@ -117,9 +148,9 @@ pub const BinaryOperator = enum {
 };
 
 pub const BinaryExpression = struct {
-    left: *Node,
+    left: NodeIndex,
     operator: BinaryOperator,
-    right: *Node,
+    right: NodeIndex,
 };
 
 pub const UnaryOperator = enum {
@@ -129,16 +160,17 @@ pub const UnaryOperator = enum {
 
 pub const UnaryExpression = struct {
     operator: UnaryOperator,
-    operand: *Node,
+    operand: NodeIndex,
 };
 
 pub const CallExpression = struct {
-    function: *Node, // Identifier
-    arguments: []*Node,
+    function: NodeIndex, // Identifier
+    arguments: ExtraRange,
 };
 
 pub const Identifier = struct {
     name: []const u8,
+    symbol: intern.Symbol,
 };
 
 pub const NumberLiteral = struct {
@@ -154,65 +186,100 @@ pub const BooleanLiteral = struct {
     value: bool,
 };
 
-// Helper functions for creating nodes
-pub fn createNode(allocator: std.mem.Allocator, node_type: NodeType, position: Position) !*Node {
-    const node = try allocator.create(Node);
-    node.node_type = node_type;
-    node.position = position;
-    return node;
-}
+// Flat syntax tree. All nodes sit in one contiguous array with u32 child
+// indices and an extra-data sidecar for variable-length lists (program and
+// block statements, call arguments). Checking and codegen traverse array
+// entries that stay L2-resident on our tree sizes instead of taking a cache
+// miss per pointer-linked node.
+pub const Ast = struct {
+    const Self = @This();
 
-pub fn createProgram(allocator: std.mem.Allocator, statements: []*Node) !*Node {
-    const node = try createNode(allocator, .program, Position{ .line = 1, .column = 1 });
-    node.data = .{ .program = Program{ .statements = statements } };
-    return node;
-}
+    nodes: std.ArrayList(Node),
+    extra: std.ArrayList(NodeIndex),
+    root: NodeIndex,
 
-pub fn createFunctionDeclaration(
-    allocator: std.mem.Allocator,
-    position: Position,
-    name: []const u8,
-    parameters: []Parameter,
-    return_type: types.Type,
-    body: *Node,
-) !*Node {
-    const node = try createNode(allocator, .function_declaration, position);
-    node.data = .{ .function_declaration = FunctionDeclaration{
-        .name = name,
-        .parameters = parameters,
-        .return_type = return_type,
-        .body = body,
-    } };
-    return node;
-}
+    pub fn init() Self {
+        return Self{
+            .nodes = std.ArrayList(Node){},
+            .extra = std.ArrayList(NodeIndex){},
+            .root = null_node,
+        };
+    }
 
-pub fn createIdentifier(allocator: std.mem.Allocator, position: Position, name: []const u8) !*Node {
-    const node = try createNode(allocator, .identifier, position);
-    node.data = .{ .identifier = Identifier{ .name = name } };
-    return node;
-}
+    // Only needed when the arrays were built with a general-purpose
+    // allocator; trees built inside an AstArena are freed in bulk by
+    // AstArena.deinit.
+    pub fn deinit(self: *Self, allocator: std.mem.Allocator) void {
+        self.nodes.deinit(allocator);
+        self.extra.deinit(allocator);
+    }
 
-pub fn createNumberLiteral(allocator: std.mem.Allocator, position: Position, value: f64, is_integer: bool) !*Node {
-    const node = try createNode(allocator, .number_literal, position);
-    node.data = .{ .number_literal = NumberLiteral{ .value = value, .is_integer = is_integer } };
-    return node;
-}
+    pub fn nodeAt(self: *const Self, index: NodeIndex) *const Node {
+        return &self.nodes.items[index];
+    }
+
+    pub fn nodeCount(self: *const Self) usize {
+        return self.nodes.items.len;
+    }
+
+    pub fn extraSlice(self: *const Self, range: ExtraRange) []const NodeIndex {
+        return self.extra.items[range.start .. range.start + range.len];
+    }
+
+    pub fn addNode(self: *Self, allocator: std.mem.Allocator, node: Node) !NodeIndex {
+        const index: NodeIndex = @intCast(self.nodes.items.len);
+        try self.nodes.append(allocator, node);
+        return index;
+    }
+
+    pub fn addExtra(self: *Self, allocator: std.mem.Allocator, indices: []const NodeIndex) !ExtraRange {
+        const start: u32 = @intCast(self.extra.items.len);
+        try self.extra.appendSlice(allocator, indices);
+        return ExtraRange{ .start = start, .len = @intCast(indices.len) };
+    }
+};
+
+// Arena that owns every node of one syntax tree. Parsing a 50k-line source
+// produces hundreds of thousands of nodes; allocating them individually through
+// the general-purpose allocator and freeing them one by one dominates parser
+// time. With an AstArena the whole tree comes out of a single arena and is
+// released in one free when the arena is deinitialized.
+pub const AstArena = struct {
+    const Self = @This();
+
+    arena: std.heap.ArenaAllocator,
+
+    pub fn init(backing_allocator: std.mem.Allocator) Self {
+        return Self{
+            .arena = std.heap.ArenaAllocator.init(backing_allocator),
+        };
+    }
+
+    pub fn deinit(self: *Self) void {
+        self.arena.deinit();
+    }
+
+    pub fn allocator(self: *Self) std.mem.Allocator {
+        return self.arena.allocator();
+    }
+};
 
 // Print AST for debugging
-pub fn printNode(node: *Node, indent: usize) void {
-    for (0..indent) |_| std.debug.print("  ");
+pub fn printNode(tree: *const Ast, index: NodeIndex, indent: usize) void {
+    for (0..indent) |_| std.debug.print("  ", .{});
 
+    const node = tree.nodeAt(index);
     switch (node.node_type) {
         .program => {
-            std.debug.print("Program\n");
-            for (node.data.program.statements) |stmt| {
-                printNode(stmt, indent + 1);
+            std.debug.print("Program\n", .{});
+            for (tree.extraSlice(node.data.program.statements)) |stmt| {
+                printNode(tree, stmt, indent + 1);
             }
         },
         .function_declaration => {
             const func = node.data.function_declaration;
             std.debug.print("FunctionDeclaration: {s}\n", .{func.name});
-            printNode(func.body, indent + 1);
+            printNode(tree, func.body, indent + 1);
         },
         .identifier => {
             std.debug.print("Identifier: {s}\n", .{node.data.identifier.name});
@@ -226,70 +293,3 @@ pub fn printNode(node: *Node, indent: usize) void {
         },
     }
 }
-
-// Cleanup function for AST nodes
-pub fn destroyNode(allocator: std.mem.Allocator, node: *Node) void {
-    switch (node.data) {
-        .program => |program| {
-            for (program.statements) |stmt| {
-                destroyNode(allocator, stmt);
-            }
-            allocator.free(program.statements);
-        },
-        .function_declaration => |func| {
-            allocator.free(func.parameters);
-            destroyNode(allocator, func.body);
-        },
-        .block_statement => |block| {
-            for (block.statements) |stmt| {
-                destroyNode(allocator, stmt);
-            }
-            allocator.free(block.statements);
-        },
-        .return_statement => |ret| {
-            if (ret.value) |value| {
-                destroyNode(allocator, value);
-            }
-        },
-        .binary_expression => |binary| {
-            destroyNode(allocator, binary.left);
-            destroyNode(allocator, binary.right);
-        },
-        .unary_expression => |unary| {
-            destroyNode(allocator, unary.operand);
-        },
-        .call_expression => |call| {
-            destroyNode(allocator, call.function);
-            for (call.arguments) |arg| {
-                destroyNode(allocator, arg);
-            }
-            allocator.free(call.arguments);
-        },
-        .variable_declaration => |var_decl| {
-            if (var_decl.initializer) |init| {
-                destroyNode(allocator, init);
-            }
-        },
-        .expression_statement => |expr_stmt| {
-            destroyNode(allocator, expr_stmt.expression);
-        },
-        .if_statement => |if_stmt| {
-            destroyNode(allocator, if_stmt.condition);
-            destroyNode(allocator, if_stmt.then_branch);
-            if (if_stmt.else_branch) |else_stmt| {
-                destroyNode(allocator, else_stmt);
-            }
-        },
-        .while_statement => |while_stmt| {
-            destroyNode(allocator, while_stmt.condition);
-            destroyNode(allocator, while_stmt.body);
-        },
-        .assignment_expression => |assign| {
-            destroyNode(allocator, assign.target);
-            destroyNode(allocator, assign.value);
-        },
-        // Leaf nodes don't need special cleanup
-        .number_literal, .string_literal, .boolean_literal, .identifier => {},
-    }
-    allocator.destroy(node);
-}
\ No newline at end of file
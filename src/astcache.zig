@@ -0,0 +1,280 @@
+const std = @import("std");
+const ast = @import("ast.zig");
+const intern = @import("intern.zig");
+
+// Binary AST cache. The flat tree is written next to the source as .zast:
+// a versioned header, the raw node and extra arrays, the parameter records,
+// and the interner's name table. Loading maps the file copy-on-write and
+// patches the embedded slices in place, so repeat front-end runs over an
+// unchanged file become a page-in instead of a re-lex and re-parse.
+//
+// Slices inside nodes all point into either the source buffer or the
+// parameter block, so they are stored in offset form (biased by one
+// element to keep the pointer non-null and aligned) and rebased against
+// the freshly mapped source on load. Interned symbol IDs stay valid
+// because the name table is re-interned in stored order into the
+// compile's interner before the tree is used.
+//
+// Node records are written with the compiler's in-memory layout, which is
+// not stable across zenc builds; format_version must be bumped whenever
+// ast.zig's node layout changes.
+pub const format_version: u32 = 3;
+
+const zast_magic: u32 = 0x5453_415A; // "ZAST" little-endian
+
+// Every section is padded to 8 bytes on disk. The node and parameter
+// records contain slices and the name refs hold u64 pairs, so the typed
+// views created over the mapping need 8-byte alignment — but the extra
+// section is 4-byte NodeIndex entries, and an odd extra_count would
+// otherwise leave everything after it misaligned.
+const section_alignment = 8;
+
+comptime {
+    std.debug.assert(@sizeOf(Header) % section_alignment == 0);
+}
+
+fn alignedSize(size: u64) u64 {
+    return std.mem.alignForward(u64, size, section_alignment);
+}
+
+const Header = extern struct {
+    magic: u32,
+    version: u32,
+    source_hash: u64,
+    node_count: u64,
+    extra_count: u64,
+    param_count: u64,
+    name_count: u64,
+    root: u32,
+    reserved: u32,
+};
+
+const NameRef = extern struct {
+    offset: u64,
+    len: u64,
+};
+
+pub fn sourceHash(source: []const u8) u64 {
+    return std.hash.Wyhash.hash(0x1f8b4c2d, source);
+}
+
+// A tree loaded from cache. The node, extra, and parameter storage all
+// alias the private mapping, so it must outlive the compile; deinit
+// releases it.
+pub const LoadedAst = struct {
+    tree: ast.Ast,
+    mapping: []align(std.heap.page_size_min) u8,
+
+    pub fn deinit(self: *LoadedAst) void {
+        std.posix.munmap(self.mapping);
+    }
+};
+
+pub fn save(allocator: std.mem.Allocator, path: []const u8, tree: *const ast.Ast, interner: *const intern.StringInterner, source: []const u8) !void {
+    const nodes = try allocator.dupe(ast.Node, tree.nodes.items);
+    defer allocator.free(nodes);
+
+    var params = std.ArrayList(ast.Parameter){};
+    defer params.deinit(allocator);
+
+    for (nodes) |*node| {
+        switch (node.node_type) {
+            .function_declaration => {
+                const func_decl = &node.data.function_declaration;
+                func_decl.name = encodeBytes(source.ptr, func_decl.name);
+                const param_offset = params.items.len * @sizeOf(ast.Parameter);
+                for (func_decl.parameters) |param| {
+                    var encoded = param;
+                    encoded.name = encodeBytes(source.ptr, encoded.name);
+                    try params.append(allocator, encoded);
+                }
+                func_decl.parameters = encodeParams(param_offset, func_decl.parameters.len);
+            },
+            .variable_declaration => {
+                const var_decl = &node.data.variable_declaration;
+                var_decl.name = encodeBytes(source.ptr, var_decl.name);
+            },
+            .for_statement => {
+                const for_stmt = &node.data.for_statement;
+                for_stmt.name = encodeBytes(source.ptr, for_stmt.name);
+            },
+            .identifier => {
+                const identifier = &node.data.identifier;
+                identifier.name = encodeBytes(source.ptr, identifier.name);
+            },
+            .string_literal => {
+                const str_literal = &node.data.string_literal;
+                str_literal.value = encodeBytes(source.ptr, str_literal.value);
+            },
+            else => {},
+        }
+    }
+
+    var names = std.ArrayList(NameRef){};
+    defer names.deinit(allocator);
+    for (interner.names.items) |name| {
+        try names.append(allocator, .{
+            .offset = @intFromPtr(name.ptr) - @intFromPtr(source.ptr),
+            .len = name.len,
+        });
+    }
+
+    const header = Header{
+        .magic = zast_magic,
+        .version = format_version,
+        .source_hash = sourceHash(source),
+        .node_count = nodes.len,
+        .extra_count = tree.extra.items.len,
+        .param_count = params.items.len,
+        .name_count = names.items.len,
+        .root = tree.root,
+        .reserved = 0,
+    };
+
+    const file = try std.fs.cwd().createFile(path, .{});
+    defer file.close();
+
+    const padding = [_]u8{0} ** section_alignment;
+    const sections = [_][]const u8{
+        std.mem.sliceAsBytes(nodes),
+        std.mem.sliceAsBytes(tree.extra.items),
+        std.mem.sliceAsBytes(params.items),
+        std.mem.sliceAsBytes(names.items),
+    };
+
+    try file.writeAll(std.mem.asBytes(&header));
+    for (sections) |section| {
+        try file.writeAll(section);
+        try file.writeAll(padding[0..@intCast(alignedSize(section.len) - section.len)]);
+    }
+}
+
+// Null on any mismatch — missing file, stale source, foreign version,
+// truncation — which all just mean a regular parse.
+pub fn load(path: []const u8, source: []const u8, interner: *intern.StringInterner) ?LoadedAst {
+    const file = std.fs.cwd().openFile(path, .{}) catch return null;
+    defer file.close();
+
+    const size = file.getEndPos() catch return null;
+    if (size < @sizeOf(Header)) return null;
+
+    // Private copy-on-write mapping: the in-place slice fixups below touch
+    // only our pages, never the file.
+    const mapping = std.posix.mmap(
+        null,
+        size,
+        std.posix.PROT.READ | std.posix.PROT.WRITE,
+        .{ .TYPE = .PRIVATE },
+        file.handle,
+        0,
+    ) catch return null;
+
+    const header: *const Header = @ptrCast(@alignCast(mapping.ptr));
+    const nodes_size = header.node_count * @sizeOf(ast.Node);
+    const extra_size = header.extra_count * @sizeOf(ast.NodeIndex);
+    const params_size = header.param_count * @sizeOf(ast.Parameter);
+    const names_size = header.name_count * @sizeOf(NameRef);
+    const expected_size = @sizeOf(Header) + alignedSize(nodes_size) + alignedSize(extra_size) +
+        alignedSize(params_size) + alignedSize(names_size);
+
+    if (header.magic != zast_magic or
+        header.version != format_version or
+        header.source_hash != sourceHash(source) or
+        size != expected_size)
+    {
+        std.posix.munmap(mapping);
+        return null;
+    }
+
+    var cursor: usize = @sizeOf(Header);
+    std.debug.assert(cursor % section_alignment == 0);
+    const nodes: []ast.Node = @alignCast(std.mem.bytesAsSlice(ast.Node, mapping[cursor .. cursor + nodes_size]));
+    cursor += @intCast(alignedSize(nodes_size));
+    std.debug.assert(cursor % section_alignment == 0);
+    const extra: []ast.NodeIndex = @alignCast(std.mem.bytesAsSlice(ast.NodeIndex, mapping[cursor .. cursor + extra_size]));
+    cursor += @intCast(alignedSize(extra_size));
+    std.debug.assert(cursor % section_alignment == 0);
+    const params: []ast.Parameter = @alignCast(std.mem.bytesAsSlice(ast.Parameter, mapping[cursor .. cursor + params_size]));
+    cursor += @intCast(alignedSize(params_size));
+    std.debug.assert(cursor % section_alignment == 0);
+    const names: []const NameRef = @alignCast(std.mem.bytesAsSlice(NameRef, mapping[cursor .. cursor + names_size]));
+
+    // Re-intern the name table in stored order so the symbol IDs baked
+    // into the nodes resolve identically in this compile's interner.
+    for (names) |name| {
+        if (name.offset + name.len > source.len) {
+            std.posix.munmap(mapping);
+            return null;
+        }
+        _ = interner.intern(source[@intCast(name.offset)..][0..@intCast(name.len)]) catch {
+            std.posix.munmap(mapping);
+            return null;
+        };
+    }
+
+    for (params) |*param| {
+        param.name = decodeBytes(source.ptr, param.name);
+    }
+
+    for (nodes) |*node| {
+        switch (node.node_type) {
+            .function_declaration => {
+                const func_decl = &node.data.function_declaration;
+                func_decl.name = decodeBytes(source.ptr, func_decl.name);
+                func_decl.parameters = decodeParams(params, func_decl.parameters);
+            },
+            .variable_declaration => {
+                const var_decl = &node.data.variable_declaration;
+                var_decl.name = decodeBytes(source.ptr, var_decl.name);
+            },
+            .for_statement => {
+                const for_stmt = &node.data.for_statement;
+                for_stmt.name = decodeBytes(source.ptr, for_stmt.name);
+            },
+            .identifier => {
+                const identifier = &node.data.identifier;
+                identifier.name = decodeBytes(source.ptr, identifier.name);
+            },
+            .string_literal => {
+                const str_literal = &node.data.string_literal;
+                str_literal.value = decodeBytes(source.ptr, str_literal.value);
+            },
+            else => {},
+        }
+    }
+
+    return LoadedAst{
+        .tree = ast.Ast{
+            .nodes = .{ .items = nodes, .capacity = nodes.len },
+            .extra = .{ .items = extra, .capacity = extra.len },
+            .root = header.root,
+        },
+        .mapping = mapping,
+    };
+}
+
+// Byte slices are stored with their source offset biased by one so the
+// fake pointer is never null; alignment is 1 so any bias works.
+fn encodeBytes(base: [*]const u8, slice: []const u8) []const u8 {
+    const offset = @intFromPtr(slice.ptr) - @intFromPtr(base);
+    const fake: [*]const u8 = @ptrFromInt(offset + 1);
+    return fake[0..slice.len];
+}
+
+fn decodeBytes(base: [*]const u8, slice: []const u8) []const u8 {
+    const offset = @intFromPtr(slice.ptr) - 1;
+    return (base + offset)[0..slice.len];
+}
+
+// Parameter slices are biased by one whole element so the fake pointer
+// stays aligned as well as non-null.
+fn encodeParams(byte_offset: usize, len: usize) []ast.Parameter {
+    const fake: [*]ast.Parameter = @ptrFromInt(byte_offset + @sizeOf(ast.Parameter));
+    return fake[0..len];
+}
+
+fn decodeParams(block: []ast.Parameter, slice: []ast.Parameter) []ast.Parameter {
+    const byte_offset = @intFromPtr(slice.ptr) - @sizeOf(ast.Parameter);
+    const start = byte_offset / @sizeOf(ast.Parameter);
+    return block[start .. start + slice.len];
+}
@@ -0,0 +1,202 @@
+const std = @import("std");
+const ast = @import("ast.zig");
+
+// Content-addressed incremental compilation cache. Each function's compiled
+// artifact (a bitcode fragment holding just that function) is stored in
+// .zen-cache under a hash of the function's AST content plus the module's
+// function signatures. On the next run, functions whose hash still resolves
+// to an artifact skip body checking and code generation entirely; the
+// fragment is linked back into the module instead. An edit to one function
+// in a 50k-line file recompiles that function and pages the rest in from
+// the cache.
+pub const cache_dir_name = ".zen-cache";
+
+const max_artifact_size = 64 * 1024 * 1024;
+
+pub const FunctionCache = struct {
+    const Self = @This();
+
+    dir: std.fs.Dir,
+
+    pub fn open() !Self {
+        return Self{ .dir = try std.fs.cwd().makeOpenPath(cache_dir_name, .{}) };
+    }
+
+    pub fn deinit(self: *Self) void {
+        self.dir.close();
+    }
+
+    pub fn contains(self: *Self, hash: u64) bool {
+        var name_buf: [24]u8 = undefined;
+        self.dir.access(artifactName(hash, &name_buf), .{}) catch return false;
+        return true;
+    }
+
+    // Caller owns the returned bytes. Null on miss or unreadable artifact;
+    // both just mean the function gets recompiled.
+    pub fn lookup(self: *Self, allocator: std.mem.Allocator, hash: u64) ?[]u8 {
+        var name_buf: [24]u8 = undefined;
+        return self.dir.readFileAlloc(allocator, artifactName(hash, &name_buf), max_artifact_size) catch null;
+    }
+
+    pub fn store(self: *Self, hash: u64, bytes: []const u8) !void {
+        var name_buf: [24]u8 = undefined;
+        try self.dir.writeFile(.{ .sub_path = artifactName(hash, &name_buf), .data = bytes });
+    }
+
+    fn artifactName(hash: u64, buf: *[24]u8) []const u8 {
+        return std.fmt.bufPrint(buf, "{x:0>16}.bc", .{hash}) catch unreachable;
+    }
+};
+
+// Hash of every top-level function signature and variable declaration in
+// the module. A function's generated code depends on the signatures of
+// what it might call and on the globals its body might read; rather than
+// tracking per-function reference sets, the whole table is folded into
+// every function hash. Globals hash as their full declaration — the
+// initializer drives type inference, so a declared-type-only hash would
+// miss an inferred change. Signature and global edits are rare next to
+// body edits, so the conservative invalidation costs little.
+pub fn hashSignatures(tree: *const ast.Ast) u64 {
+    var hasher = std.hash.Wyhash.init(0x7e3a9d41);
+
+    const program = tree.nodeAt(tree.root);
+    for (tree.extraSlice(program.data.program.statements)) |stmt| {
+        const node = tree.nodeAt(stmt);
+        switch (node.node_type) {
+            .function_declaration => {
+                const func_decl = node.data.function_declaration;
+                hasher.update(func_decl.name);
+                for (func_decl.parameters) |param| {
+                    mix(&hasher, @intFromEnum(param.param_type));
+                }
+                mix(&hasher, @intFromEnum(func_decl.return_type));
+            },
+            .variable_declaration => hashNode(tree, stmt, &hasher),
+            else => {},
+        }
+    }
+
+    return hasher.final();
+}
+
+pub fn hashFunction(tree: *const ast.Ast, index: ast.NodeIndex, signature_hash: u64) u64 {
+    var hasher = std.hash.Wyhash.init(0x2c1b0f85);
+    mix(&hasher, signature_hash);
+    hashNode(tree, index, &hasher);
+    return hasher.final();
+}
+
+fn mix(hasher: *std.hash.Wyhash, value: anytype) void {
+    const bytes = value;
+    hasher.update(std.mem.asBytes(&bytes));
+}
+
+// Structural hash of a subtree. Identifiers hash by spelling rather than
+// interner symbol so the hash doesn't shift when unrelated earlier code
+// changes symbol numbering, and positions are excluded so whitespace-only
+// edits keep every function's hash stable.
+fn hashNode(tree: *const ast.Ast, index: ast.NodeIndex, hasher: *std.hash.Wyhash) void {
+    const node = tree.nodeAt(index);
+    mix(hasher, @intFromEnum(node.node_type));
+
+    switch (node.node_type) {
+        .program => {
+            for (tree.extraSlice(node.data.program.statements)) |stmt| {
+                hashNode(tree, stmt, hasher);
+            }
+        },
+        .function_declaration => {
+            const func_decl = node.data.function_declaration;
+            hasher.update(func_decl.name);
+            for (func_decl.parameters) |param| {
+                hasher.update(param.name);
+                mix(hasher, @intFromEnum(param.param_type));
+            }
+            mix(hasher, @intFromEnum(func_decl.return_type));
+            hashNode(tree, func_decl.body, hasher);
+        },
+        .variable_declaration => {
+            const var_decl = node.data.variable_declaration;
+            hasher.update(var_decl.name);
+            mix(hasher, var_decl.is_mutable);
+            if (var_decl.var_type) |var_type| {
+                mix(hasher, @intFromEnum(var_type));
+            }
+            if (var_decl.initializer != ast.null_node) {
+                hashNode(tree, var_decl.initializer, hasher);
+            }
+        },
+        .block_statement => {
+            for (tree.extraSlice(node.data.block_statement.statements)) |stmt| {
+                hashNode(tree, stmt, hasher);
+            }
+        },
+        .return_statement => {
+            const ret_stmt = node.data.return_statement;
+            if (ret_stmt.value != ast.null_node) {
+                hashNode(tree, ret_stmt.value, hasher);
+            }
+        },
+        .expression_statement => {
+            hashNode(tree, node.data.expression_statement.expression, hasher);
+        },
+        .if_statement => {
+            const if_stmt = node.data.if_statement;
+            hashNode(tree, if_stmt.condition, hasher);
+            hashNode(tree, if_stmt.then_branch, hasher);
+            if (if_stmt.else_branch != ast.null_node) {
+                hashNode(tree, if_stmt.else_branch, hasher);
+            }
+        },
+        .while_statement => {
+            const while_stmt = node.data.while_statement;
+            hashNode(tree, while_stmt.condition, hasher);
+            hashNode(tree, while_stmt.body, hasher);
+        },
+        .for_statement => {
+            const for_stmt = node.data.for_statement;
+            hasher.update(for_stmt.name);
+            hashNode(tree, for_stmt.start, hasher);
+            hashNode(tree, for_stmt.end, hasher);
+            hashNode(tree, for_stmt.body, hasher);
+        },
+        .assignment_expression => {
+            const assign_expr = node.data.assignment_expression;
+            hashNode(tree, assign_expr.target, hasher);
+            hashNode(tree, assign_expr.value, hasher);
+        },
+        .binary_expression => {
+            const bin_expr = node.data.binary_expression;
+            mix(hasher, @intFromEnum(bin_expr.operator));
+            hashNode(tree, bin_expr.left, hasher);
+            hashNode(tree, bin_expr.right, hasher);
+        },
+        .unary_expression => {
+            const unary_expr = node.data.unary_expression;
+            mix(hasher, @intFromEnum(unary_expr.operator));
+            hashNode(tree, unary_expr.operand, hasher);
+        },
+        .call_expression => {
+            const call_expr = node.data.call_expression;
+            hashNode(tree, call_expr.function, hasher);
+            for (tree.extraSlice(call_expr.arguments)) |arg| {
+                hashNode(tree, arg, hasher);
+            }
+        },
+        .identifier => {
+            hasher.update(node.data.identifier.name);
+        },
+        .number_literal => {
+            const num_literal = node.data.number_literal;
+            mix(hasher, @as(u64, @bitCast(num_literal.value)));
+            mix(hasher, num_literal.is_integer);
+        },
+        .string_literal => {
+            hasher.update(node.data.string_literal.value);
+        },
+        .boolean_literal => {
+            mix(hasher, node.data.boolean_literal.value);
+        },
+    }
+}
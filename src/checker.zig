@@ -1,55 +1,203 @@
 const std = @import("std");
 const ast = @import("ast.zig");
 const types = @import("types.zig");
+const intern = @import("intern.zig");
+const cache = @import("cache.zig");
+const diagnostics = @import("diagnostics.zig");
 
 pub const TypeChecker = struct {
     const Self = @This();
 
     allocator: std.mem.Allocator,
+    interner: *intern.StringInterner,
     environment: types.TypeEnvironment,
     current_function_return_type: ?types.Type,
-
-    pub fn init(allocator: std.mem.Allocator) Self {
+    // The flat tree being checked; set by checkProgram for the node-index
+    // traversal helpers below.
+    tree: *const ast.Ast,
+    // When set, function bodies whose content hash resolves to a cached
+    // artifact are skipped: they checked cleanly in an earlier run with
+    // identical content.
+    function_cache: ?*cache.FunctionCache,
+    // Everything found in this run. Checking recovers at statement
+    // boundaries and keeps going, so one compile reports every error;
+    // checkProgram flushes the sorted batch and fails if any were
+    // recorded.
+    errors: diagnostics.DiagnosticList,
+    // Source text for diagnostic context lines; set by the driver.
+    source: []const u8,
+
+    pub fn init(allocator: std.mem.Allocator, interner: *intern.StringInterner) Self {
         return Self{
             .allocator = allocator,
+            .interner = interner,
             .environment = types.TypeEnvironment.init(allocator),
             .current_function_return_type = null,
+            .tree = undefined,
+            .function_cache = null,
+            .errors = diagnostics.DiagnosticList.init(allocator),
+            .source = "",
         };
     }
 
     pub fn deinit(self: *Self) void {
         self.environment.deinit();
+        self.errors.deinit();
     }
 
-    pub fn checkProgram(self: *Self, program: *ast.Node) !void {
+    pub fn checkProgram(self: *Self, tree: *const ast.Ast) !void {
+        self.tree = tree;
+
+        const program = tree.nodeAt(tree.root);
         if (program.node_type != .program) {
             return types.TypeError.TypeMismatch;
         }
 
         // First pass: collect function declarations
-        for (program.data.program.statements) |stmt| {
-            if (stmt.node_type == .function_declaration) {
+        for (tree.extraSlice(program.data.program.statements)) |stmt| {
+            if (tree.nodeAt(stmt).node_type == .function_declaration) {
                 try self.collectFunctionDeclaration(stmt);
             }
         }
 
-        // Add built-in functions
-        var builtins = try types.getBuiltinFunctions(self.allocator);
-        defer types.deinitBuiltinFunctions(self.allocator, &builtins);
+        // Second pass: check non-function statements serially (they define
+        // the top-level variables function bodies may read) and gather the
+        // function declarations for the parallel pass below.
+        var function_decls = std.ArrayList(ast.NodeIndex){};
+        defer function_decls.deinit(self.allocator);
 
-        var iterator = builtins.iterator();
-        while (iterator.next()) |entry| {
-            try self.environment.defineFunction(entry.key_ptr.*, entry.value_ptr.*);
+        for (tree.extraSlice(program.data.program.statements)) |stmt| {
+            if (tree.nodeAt(stmt).node_type == .function_declaration) {
+                try function_decls.append(self.allocator, stmt);
+            } else {
+                _ = self.checkStatement(stmt) catch |err| switch (err) {
+                    types.TypeError.OutOfMemory => return err,
+                    else => {},
+                };
+            }
         }
 
-        // Second pass: type check all statements
-        for (program.data.program.statements) |stmt| {
-            _ = try self.checkStatement(stmt);
+        try self.checkFunctionBodies(function_decls.items);
+
+        // Every diagnostic recorded above -- serial statements, worker
+        // batches, all of it -- flushes as one sorted report, and any
+        // diagnostic fails the compile.
+        if (self.errors.count() > 0) {
+            self.errors.flush(self.source);
+            return types.TypeError.TypeMismatch;
         }
     }
 
-    fn collectFunctionDeclaration(self: *Self, node: *ast.Node) !void {
-        const func_decl = node.data.function_declaration;
+    // After signature collection, function bodies only read the function
+    // table and the top-level variables, so they fan out across a thread
+    // pool. Each worker checks with its own environment — a copy of the
+    // top-level variables plus a read-only view of the signature table —
+    // so the bodies of thousands of small generated functions check
+    // concurrently instead of serially.
+    fn checkFunctionBodies(self: *Self, all_function_decls: []const ast.NodeIndex) types.TypeError!void {
+        var function_decls = all_function_decls;
+
+        var unchanged_filtered = std.ArrayList(ast.NodeIndex){};
+        defer unchanged_filtered.deinit(self.allocator);
+
+        if (self.function_cache) |function_cache| {
+            const signature_hash = cache.hashSignatures(self.tree);
+            for (all_function_decls) |decl| {
+                if (!function_cache.contains(cache.hashFunction(self.tree, decl, signature_hash))) {
+                    unchanged_filtered.append(self.allocator, decl) catch
+                        return types.TypeError.OutOfMemory;
+                }
+            }
+            function_decls = unchanged_filtered.items;
+        }
+
+        const cpu_count = std.Thread.getCpuCount() catch 1;
+        if (function_decls.len < 2 or cpu_count < 2) {
+            for (function_decls) |decl| {
+                _ = self.checkStatement(decl) catch |err| switch (err) {
+                    types.TypeError.OutOfMemory => return err,
+                    else => {},
+                };
+            }
+            return;
+        }
+
+        var pool: std.Thread.Pool = undefined;
+        pool.init(.{
+            .allocator = self.allocator,
+            .n_jobs = @min(cpu_count, function_decls.len),
+        }) catch return types.TypeError.OutOfMemory;
+        defer pool.deinit();
+
+        const results = self.allocator.alloc(WorkerOutcome, function_decls.len) catch
+            return types.TypeError.OutOfMemory;
+        defer self.allocator.free(results);
+        for (results) |*outcome| {
+            outcome.* = .{ .errors = diagnostics.DiagnosticList.init(self.allocator) };
+        }
+
+        var wait_group: std.Thread.WaitGroup = .{};
+        for (function_decls, results) |decl, *result| {
+            pool.spawnWg(&wait_group, checkFunctionJob, .{ self, decl, result });
+        }
+        pool.waitAndWork(&wait_group);
+
+        // Merge each worker's batch into the parent list; the final sort
+        // in checkProgram restores source order regardless of which worker
+        // found what.
+        var out_of_memory = false;
+        for (function_decls, results) |decl, *outcome| {
+            const reported = outcome.errors.count();
+            self.errors.adopt(&outcome.errors);
+            outcome.errors.deinit();
+            if (outcome.err) |err| {
+                if (err == types.TypeError.OutOfMemory) {
+                    out_of_memory = true;
+                } else if (reported == 0) {
+                    // A worker error with no diagnostic would otherwise let
+                    // the check pass, since checkProgram fails only on a
+                    // non-empty list. Pin a fallback report to the function.
+                    const func_decl = self.tree.nodeAt(decl).data.function_declaration;
+                    self.report(decl, "Type error in function {s}", .{func_decl.name});
+                }
+            }
+        }
+        if (out_of_memory) return types.TypeError.OutOfMemory;
+    }
+
+    const WorkerOutcome = struct {
+        err: ?types.TypeError = null,
+        errors: diagnostics.DiagnosticList,
+    };
+
+    fn checkFunctionJob(parent: *Self, decl: ast.NodeIndex, result: *WorkerOutcome) void {
+        var worker = Self{
+            .allocator = parent.allocator,
+            .interner = parent.interner,
+            .environment = types.TypeEnvironment.init(parent.allocator),
+            .current_function_return_type = null,
+            .tree = parent.tree,
+            .function_cache = null,
+            .errors = diagnostics.DiagnosticList.init(parent.allocator),
+            .source = parent.source,
+        };
+        defer worker.environment.deinit();
+        defer worker.errors.deinit();
+
+        worker.environment.shared_functions = &parent.environment.functions;
+        worker.environment.variables = parent.environment.variables.clone(parent.allocator) catch {
+            result.err = types.TypeError.OutOfMemory;
+            return;
+        };
+
+        _ = worker.checkFunctionDeclaration(decl) catch |err| {
+            result.err = err;
+        };
+        result.errors.adopt(&worker.errors);
+    }
+
+    fn collectFunctionDeclaration(self: *Self, index: ast.NodeIndex) !void {
+        const func_decl = self.tree.nodeAt(index).data.function_declaration;
 
         // Convert parameters to types
         var param_types = std.ArrayList(types.Type){};
@@ -64,34 +212,51 @@ pub const TypeChecker = struct {
             .return_type = func_decl.return_type,
         };
 
-        try self.environment.defineFunction(func_decl.name, func_type);
+        try self.environment.defineFunction(func_decl.symbol, func_type);
     }
 
-    fn checkStatement(self: *Self, node: *ast.Node) types.TypeError!types.Type {
-        switch (node.node_type) {
-            .function_declaration => return self.checkFunctionDeclaration(node),
-            .variable_declaration => return self.checkVariableDeclaration(node),
-            .block_statement => return self.checkBlockStatement(node),
-            .return_statement => return self.checkReturnStatement(node),
-            .expression_statement => return self.checkExpressionStatement(node),
-            .if_statement => return self.checkIfStatement(node),
-            .while_statement => return self.checkWhileStatement(node),
-            else => return types.TypeError.TypeMismatch,
+    // Record one diagnostic at `index`'s position. The caller still
+    // returns its error so no expression type propagates garbage; the
+    // nearest statement loop swallows it and keeps checking.
+    fn report(self: *Self, index: ast.NodeIndex, comptime fmt: []const u8, args: anytype) void {
+        self.errors.add(self.tree.nodeAt(index).position, fmt, args) catch {};
+    }
+
+    fn checkStatement(self: *Self, index: ast.NodeIndex) types.TypeError!types.Type {
+        switch (self.tree.nodeAt(index).node_type) {
+            .function_declaration => return self.checkFunctionDeclaration(index),
+            .variable_declaration => return self.checkVariableDeclaration(index),
+            .block_statement => return self.checkBlockStatement(index),
+            .return_statement => return self.checkReturnStatement(index),
+            .expression_statement => return self.checkExpressionStatement(index),
+            .if_statement => return self.checkIfStatement(index),
+            .while_statement => return self.checkWhileStatement(index),
+            .for_statement => return self.checkForStatement(index),
+            // Statement-level recovery swallows the error, so even this
+            // should-not-happen case must leave a diagnostic behind.
+            else => {
+                self.report(index, "Invalid statement", .{});
+                return types.TypeError.TypeMismatch;
+            },
         }
     }
 
-    fn checkFunctionDeclaration(self: *Self, node: *ast.Node) types.TypeError!types.Type {
-        const func_decl = node.data.function_declaration;
+    fn checkFunctionDeclaration(self: *Self, index: ast.NodeIndex) types.TypeError!types.Type {
+        const func_decl = self.tree.nodeAt(index).data.function_declaration;
 
         // Set current function context
         const previous_return_type = self.current_function_return_type;
         self.current_function_return_type = func_decl.return_type;
         defer self.current_function_return_type = previous_return_type;
 
-        // Create new scope for function parameters
-        // Note: In a full implementation, we'd push a new scope here
+        // New scope for parameters and locals; popping truncates them all
+        // away in O(1) when the function is done.
+        try self.environment.pushScope();
+        defer self.environment.popScope();
+
         for (func_decl.parameters) |param| {
-            try self.environment.defineVariable(param.name, param.param_type);
+            // Parameters keep an alloca in codegen, so they are assignable.
+            try self.environment.defineVariable(param.symbol, param.param_type, true);
         }
 
         // Type check function body
@@ -101,14 +266,14 @@ pub const TypeChecker = struct {
         return .void;
     }
 
-    fn checkVariableDeclaration(self: *Self, node: *ast.Node) types.TypeError!types.Type {
-        const var_decl = node.data.variable_declaration;
+    fn checkVariableDeclaration(self: *Self, index: ast.NodeIndex) types.TypeError!types.Type {
+        const var_decl = self.tree.nodeAt(index).data.variable_declaration;
 
         var var_type = var_decl.var_type orelse .unknown;
 
         // Type check initializer if present
-        if (var_decl.initializer) |initializer| {
-            const init_type = try self.checkExpression(initializer);
+        if (var_decl.initializer != ast.null_node) {
+            const init_type = try self.checkExpression(var_decl.initializer);
 
             if (var_type == .unknown) {
                 // Type inference
@@ -116,37 +281,45 @@ pub const TypeChecker = struct {
             } else {
                 // Type compatibility check
                 if (!types.Type.canAssignTo(init_type, var_type)) {
-                    std.debug.print("Type error: Cannot assign {s} to {s}\n", .{ init_type.toString(), var_type.toString() });
+                    self.report(index, "Cannot assign {s} to {s}", .{ init_type.toString(), var_type.toString() });
                     return types.TypeError.TypeMismatch;
                 }
             }
         }
 
-        try self.environment.defineVariable(var_decl.name, var_type);
+        try self.environment.defineVariable(var_decl.symbol, var_type, var_decl.is_mutable);
         return .void;
     }
 
-    fn checkBlockStatement(self: *Self, node: *ast.Node) types.TypeError!types.Type {
-        const block = node.data.block_statement;
+    fn checkBlockStatement(self: *Self, index: ast.NodeIndex) types.TypeError!types.Type {
+        const block = self.tree.nodeAt(index).data.block_statement;
+
+        try self.environment.pushScope();
+        defer self.environment.popScope();
 
-        for (block.statements) |stmt| {
-            _ = try self.checkStatement(stmt);
+        // Statement-granularity recovery: one bad statement doesn't hide
+        // the errors in the rest of the block.
+        for (self.tree.extraSlice(block.statements)) |stmt| {
+            _ = self.checkStatement(stmt) catch |err| switch (err) {
+                types.TypeError.OutOfMemory => return err,
+                else => {},
+            };
         }
 
         return .void;
     }
 
-    fn checkReturnStatement(self: *Self, node: *ast.Node) types.TypeError!types.Type {
-        const ret_stmt = node.data.return_statement;
+    fn checkReturnStatement(self: *Self, index: ast.NodeIndex) types.TypeError!types.Type {
+        const ret_stmt = self.tree.nodeAt(index).data.return_statement;
 
-        const return_type = if (ret_stmt.value) |value|
-            try self.checkExpression(value)
+        const return_type: types.Type = if (ret_stmt.value != ast.null_node)
+            try self.checkExpression(ret_stmt.value)
         else
             .void;
 
         if (self.current_function_return_type) |expected| {
             if (!types.Type.canAssignTo(return_type, expected)) {
-                std.debug.print("Return type mismatch: expected {s}, got {s}\n", .{ expected.toString(), return_type.toString() });
+                self.report(index, "Return type mismatch: expected {s}, got {s}", .{ expected.toString(), return_type.toString() });
                 return types.TypeError.ReturnTypeMismatch;
             }
         }
@@ -154,36 +327,36 @@ pub const TypeChecker = struct {
         return .void;
     }
 
-    fn checkExpressionStatement(self: *Self, node: *ast.Node) types.TypeError!types.Type {
-        const expr_stmt = node.data.expression_statement;
+    fn checkExpressionStatement(self: *Self, index: ast.NodeIndex) types.TypeError!types.Type {
+        const expr_stmt = self.tree.nodeAt(index).data.expression_statement;
         _ = try self.checkExpression(expr_stmt.expression);
         return .void;
     }
 
-    fn checkIfStatement(self: *Self, node: *ast.Node) types.TypeError!types.Type {
-        const if_stmt = node.data.if_statement;
+    fn checkIfStatement(self: *Self, index: ast.NodeIndex) types.TypeError!types.Type {
+        const if_stmt = self.tree.nodeAt(index).data.if_statement;
 
         const condition_type = try self.checkExpression(if_stmt.condition);
         if (condition_type != .bool) {
-            std.debug.print("If condition must be bool, got {s}\n", .{condition_type.toString()});
+            self.report(index, "If condition must be bool, got {s}", .{condition_type.toString()});
             return types.TypeError.TypeMismatch;
         }
 
         _ = try self.checkStatement(if_stmt.then_branch);
 
-        if (if_stmt.else_branch) |else_branch| {
-            _ = try self.checkStatement(else_branch);
+        if (if_stmt.else_branch != ast.null_node) {
+            _ = try self.checkStatement(if_stmt.else_branch);
         }
 
         return .void;
     }
 
-    fn checkWhileStatement(self: *Self, node: *ast.Node) types.TypeError!types.Type {
-        const while_stmt = node.data.while_statement;
+    fn checkWhileStatement(self: *Self, index: ast.NodeIndex) types.TypeError!types.Type {
+        const while_stmt = self.tree.nodeAt(index).data.while_statement;
 
         const condition_type = try self.checkExpression(while_stmt.condition);
         if (condition_type != .bool) {
-            std.debug.print("While condition must be bool, got {s}\n", .{condition_type.toString()});
+            self.report(index, "While condition must be bool, got {s}", .{condition_type.toString()});
             return types.TypeError.TypeMismatch;
         }
 
@@ -191,46 +364,87 @@ pub const TypeChecker = struct {
         return .void;
     }
 
-    fn checkExpression(self: *Self, node: *ast.Node) types.TypeError!types.Type {
-        switch (node.node_type) {
-            .assignment_expression => return self.checkAssignmentExpression(node),
-            .binary_expression => return self.checkBinaryExpression(node),
-            .unary_expression => return self.checkUnaryExpression(node),
-            .call_expression => return self.checkCallExpression(node),
-            .identifier => return self.checkIdentifier(node),
-            .number_literal => return self.checkNumberLiteral(node),
+    fn checkForStatement(self: *Self, index: ast.NodeIndex) types.TypeError!types.Type {
+        const for_stmt = self.tree.nodeAt(index).data.for_statement;
+
+        const start_type = try self.checkExpression(for_stmt.start);
+        if (start_type != .i32) {
+            self.report(index, "For range start must be i32, got {s}", .{start_type.toString()});
+            return types.TypeError.TypeMismatch;
+        }
+
+        const end_type = try self.checkExpression(for_stmt.end);
+        if (end_type != .i32) {
+            self.report(index, "For range end must be i32, got {s}", .{end_type.toString()});
+            return types.TypeError.TypeMismatch;
+        }
+
+        // The induction variable lives in its own scope around the body,
+        // so it shadows like any block-local and vanishes with the loop.
+        try self.environment.pushScope();
+        defer self.environment.popScope();
+        // The induction variable is a phi in codegen, not storage, so it
+        // is immutable like a `const`.
+        try self.environment.defineVariable(for_stmt.symbol, .i32, false);
+
+        _ = try self.checkStatement(for_stmt.body);
+        return .void;
+    }
+
+    fn checkExpression(self: *Self, index: ast.NodeIndex) types.TypeError!types.Type {
+        switch (self.tree.nodeAt(index).node_type) {
+            .assignment_expression => return self.checkAssignmentExpression(index),
+            .binary_expression => return self.checkBinaryExpression(index),
+            .unary_expression => return self.checkUnaryExpression(index),
+            .call_expression => return self.checkCallExpression(index),
+            .identifier => return self.checkIdentifier(index),
+            .number_literal => return self.checkNumberLiteral(index),
             .string_literal => return .string,
             .boolean_literal => return .bool,
-            else => return types.TypeError.TypeMismatch,
+            else => {
+                self.report(index, "Invalid expression", .{});
+                return types.TypeError.TypeMismatch;
+            },
         }
     }
 
-    fn checkAssignmentExpression(self: *Self, node: *ast.Node) types.TypeError!types.Type {
-        const assign_expr = node.data.assignment_expression;
+    fn checkAssignmentExpression(self: *Self, index: ast.NodeIndex) types.TypeError!types.Type {
+        const assign_expr = self.tree.nodeAt(index).data.assignment_expression;
 
         // Check that target is an identifier
-        if (assign_expr.target.node_type != .identifier) {
+        if (self.tree.nodeAt(assign_expr.target).node_type != .identifier) {
+            self.report(index, "Invalid assignment target", .{});
             return types.TypeError.InvalidAssignment;
         }
 
-        const target_name = assign_expr.target.data.identifier.name;
-        const target_type = self.environment.lookupVariable(target_name) orelse {
-            std.debug.print("Undefined variable: {s}\n", .{target_name});
+        const target = self.tree.nodeAt(assign_expr.target).data.identifier;
+        const binding = self.environment.lookupBinding(target.symbol) orelse {
+            self.report(index, "Undefined variable: {s}", .{target.name});
             return types.TypeError.UndefinedVariable;
         };
 
+        // `const` locals are SSA values in codegen and the folder may have
+        // already propagated their value; assignment to them has to be
+        // rejected here, with a position, not surface later as an opaque
+        // codegen failure.
+        if (!binding.is_mutable) {
+            self.report(index, "Cannot assign to immutable variable: {s}", .{target.name});
+            return types.TypeError.InvalidAssignment;
+        }
+
+        const target_type = binding.var_type;
         const value_type = try self.checkExpression(assign_expr.value);
 
         if (!types.Type.canAssignTo(value_type, target_type)) {
-            std.debug.print("Assignment type mismatch: cannot assign {s} to {s}\n", .{ value_type.toString(), target_type.toString() });
+            self.report(index, "Cannot assign {s} to {s}", .{ value_type.toString(), target_type.toString() });
             return types.TypeError.TypeMismatch;
         }
 
         return target_type;
     }
 
-    fn checkBinaryExpression(self: *Self, node: *ast.Node) types.TypeError!types.Type {
-        const bin_expr = node.data.binary_expression;
+    fn checkBinaryExpression(self: *Self, index: ast.NodeIndex) types.TypeError!types.Type {
+        const bin_expr = self.tree.nodeAt(index).data.binary_expression;
 
         const left_type = try self.checkExpression(bin_expr.left);
         const right_type = try self.checkExpression(bin_expr.right);
@@ -238,7 +452,7 @@ pub const TypeChecker = struct {
         return switch (bin_expr.operator) {
             .add, .subtract, .multiply, .divide => {
                 if (!left_type.isNumeric() or !right_type.isNumeric()) {
-                    std.debug.print("Arithmetic operation requires numeric types, got {s} and {s}\n", .{ left_type.toString(), right_type.toString() });
+                    self.report(index, "Arithmetic operation requires numeric types, got {s} and {s}", .{ left_type.toString(), right_type.toString() });
                     return types.TypeError.InvalidOperation;
                 }
                 return types.Type.getCommonType(left_type, right_type);
@@ -249,14 +463,14 @@ pub const TypeChecker = struct {
             },
             .less_than, .less_equal, .greater_than, .greater_equal => {
                 if (!left_type.isNumeric() or !right_type.isNumeric()) {
-                    std.debug.print("Comparison operation requires numeric types, got {s} and {s}\n", .{ left_type.toString(), right_type.toString() });
+                    self.report(index, "Comparison operation requires numeric types, got {s} and {s}", .{ left_type.toString(), right_type.toString() });
                     return types.TypeError.InvalidOperation;
                 }
                 return .bool;
             },
             .logical_and, .logical_or => {
                 if (left_type != .bool or right_type != .bool) {
-                    std.debug.print("Logical operation requires bool types, got {s} and {s}\n", .{ left_type.toString(), right_type.toString() });
+                    self.report(index, "Logical operation requires bool types, got {s} and {s}", .{ left_type.toString(), right_type.toString() });
                     return types.TypeError.InvalidOperation;
                 }
                 return .bool;
@@ -264,22 +478,22 @@ pub const TypeChecker = struct {
         };
     }
 
-    fn checkUnaryExpression(self: *Self, node: *ast.Node) types.TypeError!types.Type {
-        const unary_expr = node.data.unary_expression;
+    fn checkUnaryExpression(self: *Self, index: ast.NodeIndex) types.TypeError!types.Type {
+        const unary_expr = self.tree.nodeAt(index).data.unary_expression;
 
         const operand_type = try self.checkExpression(unary_expr.operand);
 
         return switch (unary_expr.operator) {
             .minus => {
                 if (!operand_type.isNumeric()) {
-                    std.debug.print("Unary minus requires numeric type, got {s}\n", .{operand_type.toString()});
+                    self.report(index, "Unary minus requires numeric type, got {s}", .{operand_type.toString()});
                     return types.TypeError.InvalidOperation;
                 }
                 return operand_type;
             },
             .logical_not => {
                 if (operand_type != .bool) {
-                    std.debug.print("Logical not requires bool type, got {s}\n", .{operand_type.toString()});
+                    self.report(index, "Logical not requires bool type, got {s}", .{operand_type.toString()});
                     return types.TypeError.InvalidOperation;
                 }
                 return .bool;
@@ -287,33 +501,40 @@ pub const TypeChecker = struct {
         };
     }
 
-    fn checkCallExpression(self: *Self, node: *ast.Node) types.TypeError!types.Type {
-        const call_expr = node.data.call_expression;
+    fn checkCallExpression(self: *Self, index: ast.NodeIndex) types.TypeError!types.Type {
+        const call_expr = self.tree.nodeAt(index).data.call_expression;
 
         // Function must be an identifier
-        if (call_expr.function.node_type != .identifier) {
+        if (self.tree.nodeAt(call_expr.function).node_type != .identifier) {
+            self.report(index, "Called value is not a function", .{});
             return types.TypeError.TypeMismatch;
         }
 
-        const func_name = call_expr.function.data.identifier.name;
-        const func_type = self.environment.lookupFunction(func_name) orelse {
-            std.debug.print("Undefined function: {s}\n", .{func_name});
+        // User functions first, then the static builtin table; builtins are
+        // never copied into the environment.
+        const callee = self.tree.nodeAt(call_expr.function).data.identifier;
+        const func_type = self.environment.lookupFunction(callee.symbol) orelse
+            types.lookupBuiltin(callee.name) orelse
+        {
+            self.report(index, "Undefined function: {s}", .{callee.name});
             return types.TypeError.UndefinedFunction;
         };
 
+        const arguments = self.tree.extraSlice(call_expr.arguments);
+
         // Check argument count
-        if (call_expr.arguments.len != func_type.parameters.len) {
-            std.debug.print("Function {s} expects {} arguments, got {}\n", .{ func_name, func_type.parameters.len, call_expr.arguments.len });
+        if (arguments.len != func_type.parameters.len) {
+            self.report(index, "Function {s} expects {} arguments, got {}", .{ callee.name, func_type.parameters.len, arguments.len });
             return types.TypeError.ArgumentCountMismatch;
         }
 
         // Check argument types
-        for (call_expr.arguments, 0..) |arg, i| {
+        for (arguments, 0..) |arg, i| {
             const arg_type = try self.checkExpression(arg);
             const param_type = func_type.parameters[i];
 
             if (!types.Type.canAssignTo(arg_type, param_type)) {
-                std.debug.print("Argument {} type mismatch: expected {s}, got {s}\n", .{ i, param_type.toString(), arg_type.toString() });
+                self.report(index, "Argument {} type mismatch: expected {s}, got {s}", .{ i, param_type.toString(), arg_type.toString() });
                 return types.TypeError.TypeMismatch;
             }
         }
@@ -321,18 +542,17 @@ pub const TypeChecker = struct {
         return func_type.return_type;
     }
 
-    fn checkIdentifier(self: *Self, node: *ast.Node) types.TypeError!types.Type {
-        const identifier = node.data.identifier;
+    fn checkIdentifier(self: *Self, index: ast.NodeIndex) types.TypeError!types.Type {
+        const identifier = self.tree.nodeAt(index).data.identifier;
 
-        return self.environment.lookupVariable(identifier.name) orelse {
-            std.debug.print("Undefined variable: {s}\n", .{identifier.name});
+        return self.environment.lookupVariable(identifier.symbol) orelse {
+            self.report(index, "Undefined variable: {s}", .{identifier.name});
             return types.TypeError.UndefinedVariable;
         };
     }
 
-    fn checkNumberLiteral(self: *Self, node: *ast.Node) types.TypeError!types.Type {
-        _ = self; // Mark as used
-        const num_literal = node.data.number_literal;
+    fn checkNumberLiteral(self: *Self, index: ast.NodeIndex) types.TypeError!types.Type {
+        const num_literal = self.tree.nodeAt(index).data.number_literal;
         return if (num_literal.is_integer) .i32 else .f64;
     }
 };
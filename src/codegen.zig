@@ -2,10 +2,43 @@ const std = @import("std");
 const llvm = @import("llvm");
 const ast = @import("ast.zig");
 const types = @import("types.zig");
+const intern = @import("intern.zig");
+const cache = @import("cache.zig");
 
 // LLVM-C API Code Generator using llvm-zig bindings
 // This replaces the LLVM IR text generation with direct LLVM API calls
 
+// Output format for one compile: textual IR for debugging, or a native
+// object written straight from the in-memory module, skipping the
+// .ll-serialize-then-reparse round trip through clang.
+pub const EmitKind = enum {
+    ll,
+    obj,
+};
+
+// Optimization level mapped onto a new-pass-manager default pipeline.
+// Running the passes in-process replaces the old bolt-on clang invocation
+// over the .ll text.
+pub const OptLevel = enum {
+    O0,
+    O1,
+    O2,
+    O3,
+
+    fn pipeline(self: OptLevel) [:0]const u8 {
+        return switch (self) {
+            // Even unoptimized builds promote allocas to registers;
+            // without it every scalar access round-trips through the
+            // stack and hot loops run several times slower than they
+            // need to.
+            .O0 => "function(mem2reg)",
+            .O1 => "default<O1>",
+            .O2 => "default<O2>",
+            .O3 => "default<O3>",
+        };
+    }
+};
+
 pub const CodeGenError = error{
     UndefinedVariable,
     UndefinedFunction,
@@ -18,42 +51,117 @@ pub const CodeGenerator = struct {
     const Self = @This();
 
     allocator: std.mem.Allocator,
+    interner: *intern.StringInterner,
 
     // LLVM Context and Module
     context: llvm.LLVMContextRef,
     module: llvm.LLVMModuleRef,
     builder: llvm.LLVMBuilderRef,
 
-    // Function and variable tracking
+    // Function and variable tracking, keyed by interned symbol so codegen
+    // lookups hash a u32 instead of the identifier spelling.
     current_function: ?llvm.LLVMValueRef,
-    local_variables: std.StringHashMap(llvm.LLVMValueRef),
-    functions: std.StringHashMap(llvm.LLVMValueRef),
+    local_variables: std.AutoHashMap(intern.Symbol, Local),
+    functions: std.AutoHashMap(intern.Symbol, llvm.LLVMValueRef),
+
+    // One global per distinct string content, shared by every use in the
+    // module. Keyed by the content bytes rather than an interner symbol:
+    // string literal spellings aren't interned by the lexer, and interning
+    // them here would mutate the shared interner from parallel codegen
+    // workers, which only ever read it.
+    string_globals: std.StringHashMap(llvm.LLVMValueRef),
+
+    // The flat tree being lowered; set by generateProgram for the
+    // node-index traversal below.
+    tree: *const ast.Ast,
+
+    // When set, functions are compiled one per module so their bitcode can
+    // be cached by content hash and unchanged ones linked back in without
+    // regeneration.
+    function_cache: ?*cache.FunctionCache,
+
+    // False when the context was handed in by the caller (watch mode keeps
+    // one context warm across recompiles); deinit then leaves it alive.
+    owns_context: bool,
+
+    // One local binding. Immutable `const` locals are tracked directly as
+    // the SSA value of their initializer; mutable `let` locals and
+    // parameters keep an alloca and go through load/store.
+    const Local = struct {
+        value: llvm.LLVMValueRef,
+        llvm_type: llvm.LLVMTypeRef,
+        is_alloca: bool,
+    };
+
+    // What a scoped binding displaced in local_variables, and so what to
+    // put back when its scope ends. The checker's scope stack makes
+    // shadowing legal, so the flat map here has to be unwound in step or
+    // an outer use after the scope would silently resolve to the inner
+    // variable.
+    const SavedBinding = struct {
+        symbol: intern.Symbol,
+        previous: ?Local,
+    };
+
+    fn bindLocal(self: *Self, symbol: intern.Symbol, local: Local) !SavedBinding {
+        const saved = SavedBinding{ .symbol = symbol, .previous = self.local_variables.get(symbol) };
+        try self.local_variables.put(symbol, local);
+        return saved;
+    }
+
+    fn restoreLocal(self: *Self, saved: SavedBinding) void {
+        if (saved.previous) |previous| {
+            // The slot exists, so this put never allocates.
+            self.local_variables.put(saved.symbol, previous) catch unreachable;
+        } else {
+            _ = self.local_variables.remove(saved.symbol);
+        }
+    }
 
-    pub fn init(allocator: std.mem.Allocator) Self {
-        const context = llvm.LLVMContextCreate();
+    pub fn init(allocator: std.mem.Allocator, interner: *intern.StringInterner) Self {
+        var self = initInContext(allocator, interner, llvm.LLVMContextCreate());
+        self.owns_context = true;
+        return self;
+    }
+
+    // Generate into a caller-owned context. The module and builder are still
+    // per-compile; only LLVMContextCreate/Dispose are amortized. The caller
+    // must not run two compiles in the same context concurrently.
+    pub fn initInContext(allocator: std.mem.Allocator, interner: *intern.StringInterner, context: llvm.LLVMContextRef) Self {
         const module = llvm.LLVMModuleCreateWithNameInContext("zen_module", context);
         const builder = llvm.LLVMCreateBuilderInContext(context);
 
         return Self{
             .allocator = allocator,
+            .interner = interner,
             .context = context,
             .module = module,
             .builder = builder,
             .current_function = null,
-            .local_variables = std.StringHashMap(llvm.LLVMValueRef).init(allocator),
-            .functions = std.StringHashMap(llvm.LLVMValueRef).init(allocator),
+            .local_variables = std.AutoHashMap(intern.Symbol, Local).init(allocator),
+            .functions = std.AutoHashMap(intern.Symbol, llvm.LLVMValueRef).init(allocator),
+            .string_globals = std.StringHashMap(llvm.LLVMValueRef).init(allocator),
+            .tree = undefined,
+            .function_cache = null,
+            .owns_context = false,
         };
     }
 
     pub fn deinit(self: *Self) void {
         self.local_variables.deinit();
         self.functions.deinit();
+        self.string_globals.deinit();
         llvm.LLVMDisposeBuilder(self.builder);
         llvm.LLVMDisposeModule(self.module);
-        llvm.LLVMContextDispose(self.context);
+        if (self.owns_context) {
+            llvm.LLVMContextDispose(self.context);
+        }
     }
 
-    pub fn generateProgram(self: *Self, program: *ast.Node, filename: []const u8) !void {
+    pub fn generateProgram(self: *Self, tree: *const ast.Ast, filename: []const u8, emit: EmitKind, opt: OptLevel) !void {
+        self.tree = tree;
+
+        const program = tree.nodeAt(tree.root);
         if (program.node_type != .program) {
             return CodeGenError.InvalidOperation;
         }
@@ -65,9 +173,29 @@ pub const CodeGenerator = struct {
         // Create built-in functions
         try self.createBuiltinFunctions();
 
-        // Generate code for all statements
-        for (program.data.program.statements) |stmt| {
-            try self.generateStatement(stmt);
+        // Generate non-function statements serially and gather function
+        // declarations, which fan out across worker contexts when there
+        // are enough of them to pay for the setup.
+        var function_decls = std.ArrayList(ast.NodeIndex){};
+        defer function_decls.deinit(self.allocator);
+
+        for (tree.extraSlice(program.data.program.statements)) |stmt| {
+            if (tree.nodeAt(stmt).node_type == .function_declaration) {
+                try function_decls.append(self.allocator, stmt);
+            } else {
+                try self.generateStatement(stmt);
+            }
+        }
+
+        const cpu_count = std.Thread.getCpuCount() catch 1;
+        if (self.function_cache) |function_cache| {
+            try self.generateFunctionsCached(function_cache, function_decls.items);
+        } else if (function_decls.items.len >= parallel_codegen_threshold and cpu_count > 1) {
+            try self.generateFunctionsParallel(function_decls.items, cpu_count);
+        } else {
+            for (function_decls.items) |decl| {
+                try self.generateStatement(decl);
+            }
         }
 
         // Verify the module
@@ -78,116 +206,325 @@ pub const CodeGenerator = struct {
             return CodeGenError.LLVMError;
         }
 
-        // Output LLVM IR to file
-        const output_filename = try std.fmt.allocPrint(self.allocator, "{s}.ll", .{filename[0 .. filename.len - 4]});
+        try self.runOptimizationPasses(opt);
+
+        // Write the module in the requested format
+        const extension = switch (emit) {
+            .ll => "ll",
+            .obj => "o",
+        };
+        const output_filename = try std.fmt.allocPrintZ(self.allocator, "{s}.{s}", .{ filename[0 .. filename.len - 4], extension });
         defer self.allocator.free(output_filename);
 
-        const output_filename_cstr = try std.fmt.allocPrintZ(self.allocator, "{s}", .{output_filename});
-        defer self.allocator.free(output_filename_cstr);
+        switch (emit) {
+            .ll => try self.emitTextualIR(output_filename),
+            .obj => try self.emitObjectFile(output_filename),
+        }
+    }
 
-        var error_message: [*c]u8 = null;
-        if (llvm.LLVMPrintModuleToFile(self.module, output_filename_cstr.ptr, &error_message) != 0) {
-            std.debug.print("Failed to write LLVM IR file: {s}\n", .{error_message});
-            llvm.LLVMDisposeMessage(error_message);
-            return CodeGenError.LLVMError;
+    // Instruction count of the generated module, for the driver's
+    // --time-report. Walks what's already in memory; no LLVM analysis runs.
+    pub fn instructionCount(self: *Self) u64 {
+        var count: u64 = 0;
+        var function = llvm.LLVMGetFirstFunction(self.module);
+        while (function != null) : (function = llvm.LLVMGetNextFunction(function)) {
+            var block = llvm.LLVMGetFirstBasicBlock(function);
+            while (block != null) : (block = llvm.LLVMGetNextBasicBlock(block)) {
+                var instruction = llvm.LLVMGetFirstInstruction(block);
+                while (instruction != null) : (instruction = llvm.LLVMGetNextInstruction(instruction)) {
+                    count += 1;
+                }
+            }
+        }
+        return count;
+    }
+
+    // Below this many top-level functions the per-worker context and
+    // bitcode round trip cost more than the serial loop they replace.
+    const parallel_codegen_threshold = 8;
+
+    const WorkerResult = struct {
+        bitcode: ?llvm.LLVMMemoryBufferRef = null,
+        failed: bool = false,
+    };
+
+    // LLVM contexts are single-threaded, but independent contexts are not:
+    // partition the functions across workers that each own a context and
+    // module, then merge the results back into the main module. Modules
+    // from different contexts can't be linked directly, so each worker
+    // hands back a bitcode buffer that is re-parsed in the main context
+    // and folded in with LLVMLinkModules2. The interner is shared but only
+    // read by the workers: every name they touch was interned by the front
+    // end or pre-interned below, and their builtin setup resolves through
+    // the interner's read-only find.
+    fn generateFunctionsParallel(self: *Self, function_decls: []const ast.NodeIndex, cpu_count: usize) !void {
+        // Even a getOrPut hit can grow and rehash the interner's table, so
+        // every builtin name must be interned before the workers run their
+        // own createBuiltinFunctions concurrently.
+        inline for (types.builtin_functions) |builtin| {
+            _ = try self.interner.intern(builtin.name);
+        }
+
+        // Declare everything in the main module so serial top-level code
+        // can reference functions; the definitions arrive via linking.
+        for (function_decls) |decl| {
+            _ = try self.declareFunction(decl);
         }
 
-        std.debug.print("Generated LLVM IR: {s}\n", .{output_filename});
+        const max_workers = @min(cpu_count, function_decls.len);
+        const chunk_size = (function_decls.len + max_workers - 1) / max_workers;
+        // With uneven chunks the tail workers can end up with nothing;
+        // only spawn workers that own at least one function.
+        const worker_count = (function_decls.len + chunk_size - 1) / chunk_size;
+
+        var pool: std.Thread.Pool = undefined;
+        try pool.init(.{ .allocator = self.allocator, .n_jobs = worker_count });
+        defer pool.deinit();
+
+        const results = try self.allocator.alloc(WorkerResult, worker_count);
+        defer self.allocator.free(results);
+        @memset(results, .{});
+
+        var wait_group: std.Thread.WaitGroup = .{};
+        for (results, 0..) |*result, worker| {
+            const start = worker * chunk_size;
+            const end = @min(start + chunk_size, function_decls.len);
+            pool.spawnWg(&wait_group, codegenWorker, .{ self, function_decls, function_decls[start..end], result });
+        }
+        pool.waitAndWork(&wait_group);
+
+        // Every buffer is released here, so an early error return below
+        // doesn't leak the remaining workers' bitcode.
+        defer for (results) |result| {
+            if (result.bitcode) |bitcode| llvm.LLVMDisposeMemoryBuffer(bitcode);
+        };
+
+        for (results) |result| {
+            if (result.failed) return CodeGenError.LLVMError;
+            const bitcode = result.bitcode orelse return CodeGenError.LLVMError;
+
+            var worker_module: llvm.LLVMModuleRef = undefined;
+            if (llvm.LLVMParseBitcodeInContext2(self.context, bitcode, &worker_module) != 0) {
+                std.debug.print("Failed to re-parse worker module bitcode\n", .{});
+                return CodeGenError.LLVMError;
+            }
+            if (llvm.LLVMLinkModules2(self.module, worker_module) != 0) {
+                std.debug.print("Failed to link worker module\n", .{});
+                return CodeGenError.LLVMError;
+            }
+        }
     }
 
-    fn createBuiltinFunctions(self: *Self) !void {
-        // Create printf declaration
-        const printf_type = llvm.LLVMFunctionType(
-            llvm.LLVMInt32TypeInContext(self.context), // return type: i32
-            @ptrCast(&llvm.LLVMPointerTypeInContext(self.context, 0)), // first param: i8*
-            1, // param count
-            1  // is_varargs
-        );
-        const printf_func = llvm.LLVMAddFunction(self.module, "printf", printf_type);
-        try self.functions.put("printf", printf_func);
-
-        // Create print function (wrapper around printf)
-        const print_type = llvm.LLVMFunctionType(
-            llvm.LLVMVoidTypeInContext(self.context), // return type: void
-            @ptrCast(&llvm.LLVMPointerTypeInContext(self.context, 0)), // param: i8*
-            1, // param count
-            0  // is_varargs
-        );
-        const print_func = llvm.LLVMAddFunction(self.module, "print", print_type);
-        try self.functions.put("print", print_func);
+    fn codegenWorker(parent: *Self, all_decls: []const ast.NodeIndex, own_decls: []const ast.NodeIndex, result: *WorkerResult) void {
+        var generator = CodeGenerator.init(parent.allocator, parent.interner);
+        defer generator.deinit();
+        generator.tree = parent.tree;
 
-        // Implement print function body
-        const print_entry = llvm.LLVMAppendBasicBlockInContext(self.context, print_func, "entry");
-        llvm.LLVMPositionBuilderAtEnd(self.builder, print_entry);
+        const target_triple = llvm.LLVMGetDefaultTargetTriple();
+        llvm.LLVMSetTarget(generator.module, target_triple);
+        llvm.LLVMDisposeMessage(target_triple);
 
-        // Get the parameter
-        const str_param = llvm.LLVMGetParam(print_func, 0);
+        generator.generateWorkerSlice(all_decls, own_decls) catch {
+            result.failed = true;
+            return;
+        };
 
-        // Create format string for printf ("%s\n")
-        const format_str = llvm.LLVMBuildGlobalStringPtr(self.builder, "%s\n", "print.fmt");
+        result.bitcode = llvm.LLVMWriteBitcodeToMemoryBuffer(generator.module);
+    }
 
-        // Call printf
-        const printf_args = [_]llvm.LLVMValueRef{ format_str, str_param };
-        _ = llvm.LLVMBuildCall2(self.builder, printf_type, printf_func, @ptrCast(&printf_args), 2, "");
+    fn generateWorkerSlice(self: *Self, all_decls: []const ast.NodeIndex, own_decls: []const ast.NodeIndex) !void {
+        // Builtins and every user function as extern declarations, so
+        // calls across partitions resolve; only this worker's slice gets
+        // bodies.
+        try self.createBuiltinFunctions();
+        for (all_decls) |decl| {
+            _ = try self.declareFunction(decl);
+        }
+        for (own_decls) |decl| {
+            try self.generateFunctionDeclaration(decl);
+        }
+    }
 
-        // Return void
-        _ = llvm.LLVMBuildRetVoid(self.builder);
+    // Incremental mode: every function is compiled in its own module and
+    // keyed by its content hash. Hits are linked back in from the cache
+    // without regenerating anything; misses are generated, stored, and
+    // linked. This reuses the worker machinery from the parallel path —
+    // the single-function module simply round-trips through the cache
+    // instead of a thread.
+    fn generateFunctionsCached(self: *Self, function_cache: *cache.FunctionCache, function_decls: []const ast.NodeIndex) !void {
+        for (function_decls) |decl| {
+            _ = try self.declareFunction(decl);
+        }
 
-        // Create print_int function
-        const print_int_type = llvm.LLVMFunctionType(
-            llvm.LLVMVoidTypeInContext(self.context), // return type: void
-            @ptrCast(&llvm.LLVMInt32TypeInContext(self.context)), // param: i32
-            1, // param count
-            0  // is_varargs
-        );
-        const print_int_func = llvm.LLVMAddFunction(self.module, "print_int", print_int_type);
-        try self.functions.put("print_int", print_int_func);
+        const signature_hash = cache.hashSignatures(self.tree);
+
+        for (function_decls) |decl| {
+            const hash = cache.hashFunction(self.tree, decl, signature_hash);
+
+            if (function_cache.lookup(self.allocator, hash)) |bytes| {
+                defer self.allocator.free(bytes);
+                try self.linkBitcodeBytes(bytes);
+                continue;
+            }
 
-        // Implement print_int function body
-        const print_int_entry = llvm.LLVMAppendBasicBlockInContext(self.context, print_int_func, "entry");
-        llvm.LLVMPositionBuilderAtEnd(self.builder, print_int_entry);
+            var generator = CodeGenerator.init(self.allocator, self.interner);
+            defer generator.deinit();
+            generator.tree = self.tree;
 
-        // Get the parameter
-        const int_param = llvm.LLVMGetParam(print_int_func, 0);
+            const target_triple = llvm.LLVMGetDefaultTargetTriple();
+            llvm.LLVMSetTarget(generator.module, target_triple);
+            llvm.LLVMDisposeMessage(target_triple);
 
-        // Create format string for printf ("%d\n")
-        const int_format_str = llvm.LLVMBuildGlobalStringPtr(self.builder, "%d\n", "print_int.fmt");
+            try generator.generateWorkerSlice(function_decls, &.{decl});
 
-        // Call printf
-        const printf_int_args = [_]llvm.LLVMValueRef{ int_format_str, int_param };
-        _ = llvm.LLVMBuildCall2(self.builder, printf_type, printf_func, @ptrCast(&printf_int_args), 2, "");
+            const bitcode = llvm.LLVMWriteBitcodeToMemoryBuffer(generator.module);
+            defer llvm.LLVMDisposeMemoryBuffer(bitcode);
 
-        // Return void
-        _ = llvm.LLVMBuildRetVoid(self.builder);
+            const start: [*]const u8 = @ptrCast(llvm.LLVMGetBufferStart(bitcode));
+            const bytes = start[0..llvm.LLVMGetBufferSize(bitcode)];
+            // A failed cache write only costs a recompile next run.
+            function_cache.store(hash, bytes) catch {};
+            try self.linkBitcodeBytes(bytes);
+        }
     }
 
-    fn generateStatement(self: *Self, node: *ast.Node) CodeGenError!void {
-        switch (node.node_type) {
-            .function_declaration => try self.generateFunctionDeclaration(node),
-            .variable_declaration => try self.generateVariableDeclaration(node),
-            .block_statement => try self.generateBlockStatement(node),
-            .return_statement => try self.generateReturnStatement(node),
-            .expression_statement => try self.generateExpressionStatement(node),
-            .if_statement => try self.generateIfStatement(node),
-            .while_statement => try self.generateWhileStatement(node),
-            else => return CodeGenError.InvalidOperation,
+    fn linkBitcodeBytes(self: *Self, bytes: []const u8) CodeGenError!void {
+        const buffer = llvm.LLVMCreateMemoryBufferWithMemoryRange(bytes.ptr, bytes.len, "zen-cache", 0);
+        defer llvm.LLVMDisposeMemoryBuffer(buffer);
+
+        var fragment_module: llvm.LLVMModuleRef = undefined;
+        if (llvm.LLVMParseBitcodeInContext2(self.context, buffer, &fragment_module) != 0) {
+            std.debug.print("Failed to parse cached bitcode fragment\n", .{});
+            return CodeGenError.LLVMError;
+        }
+        if (llvm.LLVMLinkModules2(self.module, fragment_module) != 0) {
+            std.debug.print("Failed to link cached bitcode fragment\n", .{});
+            return CodeGenError.LLVMError;
         }
     }
 
-    fn generateFunctionDeclaration(self: *Self, node: *ast.Node) CodeGenError!void {
-        const func_decl = node.data.function_declaration;
+    fn runOptimizationPasses(self: *Self, opt: OptLevel) CodeGenError!void {
+        const pipeline = opt.pipeline();
 
-        // Clear local variables for new function
-        self.local_variables.clearAndFree();
+        const pass_options = llvm.LLVMCreatePassBuilderOptions();
+        defer llvm.LLVMDisposePassBuilderOptions(pass_options);
+
+        const err = llvm.LLVMRunPasses(self.module, pipeline.ptr, null, pass_options);
+        if (err != null) {
+            const message = llvm.LLVMGetErrorMessage(err);
+            std.debug.print("Optimization pipeline '{s}' failed: {s}\n", .{ pipeline, message });
+            llvm.LLVMDisposeErrorMessage(message);
+            return CodeGenError.LLVMError;
+        }
+    }
+
+    fn emitTextualIR(self: *Self, output_filename: [:0]const u8) CodeGenError!void {
+        var error_message: [*c]u8 = null;
+        if (llvm.LLVMPrintModuleToFile(self.module, output_filename.ptr, &error_message) != 0) {
+            std.debug.print("Failed to write LLVM IR file: {s}\n", .{error_message});
+            llvm.LLVMDisposeMessage(error_message);
+            return CodeGenError.LLVMError;
+        }
+    }
+
+    // Native object output: run the module through a target machine and
+    // write a .o directly, so nothing serializes IR to text or re-parses
+    // it in another process.
+    fn emitObjectFile(self: *Self, output_filename: [:0]const u8) CodeGenError!void {
+        llvm.LLVMInitializeAllTargetInfos();
+        llvm.LLVMInitializeAllTargets();
+        llvm.LLVMInitializeAllTargetMCs();
+        llvm.LLVMInitializeAllAsmPrinters();
+        llvm.LLVMInitializeAllAsmParsers();
+
+        const target_triple = llvm.LLVMGetDefaultTargetTriple();
+        defer llvm.LLVMDisposeMessage(target_triple);
+
+        var target: llvm.LLVMTargetRef = undefined;
+        var error_message: [*c]u8 = null;
+        if (llvm.LLVMGetTargetFromTriple(target_triple, &target, &error_message) != 0) {
+            std.debug.print("Failed to find target: {s}\n", .{error_message});
+            llvm.LLVMDisposeMessage(error_message);
+            return CodeGenError.LLVMError;
+        }
+
+        const target_machine = llvm.LLVMCreateTargetMachine(
+            target,
+            target_triple,
+            "generic", // cpu
+            "", // features
+            llvm.LLVMCodeGenOptLevel.LLVMCodeGenLevelDefault,
+            llvm.LLVMRelocMode.LLVMRelocDefault,
+            llvm.LLVMCodeModel.LLVMCodeModelDefault,
+        );
+        defer llvm.LLVMDisposeTargetMachine(target_machine);
+
+        if (llvm.LLVMTargetMachineEmitToFile(target_machine, self.module, output_filename.ptr, llvm.LLVMCodeGenFileType.LLVMObjectFile, &error_message) != 0) {
+            std.debug.print("Failed to write object file: {s}\n", .{error_message});
+            llvm.LLVMDisposeMessage(error_message);
+            return CodeGenError.LLVMError;
+        }
+    }
+
+    // One extern declaration per entry in the shared builtin table,
+    // resolved against the buffered writers in src/zen_runtime.c at link
+    // time. Builtins used to be printf-forwarding wrapper bodies, which
+    // meant one format-parsing libc call per print and a definitions/
+    // declarations split so merged worker modules wouldn't collide; as
+    // pure declarations every module emits the same thing.
+    fn createBuiltinFunctions(self: *Self) !void {
+        inline for (types.builtin_functions) |builtin| {
+            const param_count = builtin.func_type.parameters.len;
+
+            var param_types: [param_count]llvm.LLVMTypeRef = undefined;
+            inline for (builtin.func_type.parameters, 0..) |param_type, i| {
+                param_types[i] = self.typeToLLVMType(param_type);
+            }
+
+            const runtime_type = llvm.LLVMFunctionType(
+                self.typeToLLVMType(builtin.func_type.return_type),
+                &param_types,
+                param_count,
+                0 // not varargs
+            );
+            const runtime_func = llvm.LLVMAddFunction(self.module, builtin.runtime_symbol.ptr, runtime_type);
+            // Resolve through the read-only path first: parallel workers
+            // share the interner, and the main module's setup has already
+            // interned every builtin name by the time they run.
+            const symbol = self.interner.find(builtin.name) orelse try self.interner.intern(builtin.name);
+            try self.functions.put(symbol, runtime_func);
+        }
+    }
+
+    fn generateStatement(self: *Self, index: ast.NodeIndex) CodeGenError!void {
+        switch (self.tree.nodeAt(index).node_type) {
+            .function_declaration => try self.generateFunctionDeclaration(index),
+            // Top level: the binding never goes out of scope, so the saved
+            // shadow is irrelevant.
+            .variable_declaration => _ = try self.generateVariableDeclaration(index),
+            .block_statement => try self.generateBlockStatement(index),
+            .return_statement => try self.generateReturnStatement(index),
+            .expression_statement => try self.generateExpressionStatement(index),
+            .if_statement => try self.generateIfStatement(index),
+            .while_statement => try self.generateWhileStatement(index),
+            .for_statement => try self.generateForStatement(index),
+            else => return CodeGenError.InvalidOperation,
+        }
+    }
+
+    // Add the function to the module with its signature only; the body is
+    // generated separately so parallel workers can declare every function
+    // for cross-partition calls but define just their own slice.
+    fn declareFunction(self: *Self, index: ast.NodeIndex) CodeGenError!llvm.LLVMValueRef {
+        const func_decl = self.tree.nodeAt(index).data.function_declaration;
 
-        // Create function type
         const return_llvm_type = self.typeToLLVMType(func_decl.return_type);
 
-        var param_types = std.ArrayList(llvm.LLVMTypeRef).init(self.allocator);
-        defer param_types.deinit();
+        var param_types = std.ArrayList(llvm.LLVMTypeRef){};
+        defer param_types.deinit(self.allocator);
 
         for (func_decl.parameters) |param| {
-            try param_types.append(self.typeToLLVMType(param.param_type));
+            try param_types.append(self.allocator, self.typeToLLVMType(param.param_type));
         }
 
         const function_type = llvm.LLVMFunctionType(
@@ -197,12 +534,21 @@ pub const CodeGenerator = struct {
             0 // not varargs
         );
 
-        // Create function
         const func_name_cstr = try std.fmt.allocPrintZ(self.allocator, "{s}", .{func_decl.name});
         defer self.allocator.free(func_name_cstr);
 
         const function = llvm.LLVMAddFunction(self.module, func_name_cstr.ptr, function_type);
-        try self.functions.put(func_decl.name, function);
+        try self.functions.put(func_decl.symbol, function);
+        return function;
+    }
+
+    fn generateFunctionDeclaration(self: *Self, index: ast.NodeIndex) CodeGenError!void {
+        const func_decl = self.tree.nodeAt(index).data.function_declaration;
+
+        const function = self.functions.get(func_decl.symbol) orelse try self.declareFunction(index);
+
+        // Clear local variables for new function
+        self.local_variables.clearAndFree();
         self.current_function = function;
 
         // Create entry block
@@ -222,13 +568,17 @@ pub const CodeGenerator = struct {
             const param_alloca = llvm.LLVMBuildAlloca(self.builder, self.typeToLLVMType(param.param_type), param_name_cstr.ptr);
             _ = llvm.LLVMBuildStore(self.builder, param_value, param_alloca);
 
-            try self.local_variables.put(param.name, param_alloca);
+            try self.local_variables.put(param.symbol, .{
+                .value = param_alloca,
+                .llvm_type = self.typeToLLVMType(param.param_type),
+                .is_alloca = true,
+            });
         }
 
         // Generate function body
-        if (func_decl.body.node_type == .block_statement) {
-            const block = func_decl.body.data.block_statement;
-            for (block.statements) |stmt| {
+        const body = self.tree.nodeAt(func_decl.body);
+        if (body.node_type == .block_statement) {
+            for (self.tree.extraSlice(body.data.block_statement.statements)) |stmt| {
                 try self.generateStatement(stmt);
             }
         }
@@ -242,58 +592,92 @@ pub const CodeGenerator = struct {
         }
     }
 
-    fn generateVariableDeclaration(self: *Self, node: *ast.Node) CodeGenError!void {
-        const var_decl = node.data.variable_declaration;
+    fn generateVariableDeclaration(self: *Self, index: ast.NodeIndex) CodeGenError!SavedBinding {
+        const var_decl = self.tree.nodeAt(index).data.variable_declaration;
 
         const var_type = var_decl.var_type orelse .i32;
         const llvm_type = self.typeToLLVMType(var_type);
 
+        // Immutable binding with an initializer: the initializer's SSA
+        // value simply is the variable — no alloca, no load/store.
+        if (!var_decl.is_mutable and var_decl.initializer != ast.null_node) {
+            const init_value = try self.generateExpression(var_decl.initializer);
+            return self.bindLocal(var_decl.symbol, .{
+                .value = init_value,
+                .llvm_type = llvm_type,
+                .is_alloca = false,
+            });
+        }
+
         // Create alloca for the variable
         const var_name_cstr = try std.fmt.allocPrintZ(self.allocator, "{s}", .{var_decl.name});
         defer self.allocator.free(var_name_cstr);
 
         const alloca = llvm.LLVMBuildAlloca(self.builder, llvm_type, var_name_cstr.ptr);
-        try self.local_variables.put(var_decl.name, alloca);
+        const saved = try self.bindLocal(var_decl.symbol, .{
+            .value = alloca,
+            .llvm_type = llvm_type,
+            .is_alloca = true,
+        });
 
         // Initialize if there's an initializer
-        if (var_decl.initializer) |initializer| {
-            const init_value = try self.generateExpression(initializer);
+        if (var_decl.initializer != ast.null_node) {
+            const init_value = try self.generateExpression(var_decl.initializer);
             _ = llvm.LLVMBuildStore(self.builder, init_value, alloca);
         }
+
+        return saved;
     }
 
-    fn generateBlockStatement(self: *Self, node: *ast.Node) CodeGenError!void {
-        const block = node.data.block_statement;
+    fn generateBlockStatement(self: *Self, index: ast.NodeIndex) CodeGenError!void {
+        const block = self.tree.nodeAt(index).data.block_statement;
+
+        // Variables declared in this block are visible only until it ends;
+        // restore what they shadowed, in reverse so a symbol declared twice
+        // in the block unwinds to its pre-block binding.
+        var saved = std.ArrayList(SavedBinding){};
+        defer {
+            var i = saved.items.len;
+            while (i > 0) {
+                i -= 1;
+                self.restoreLocal(saved.items[i]);
+            }
+            saved.deinit(self.allocator);
+        }
 
-        for (block.statements) |stmt| {
-            try self.generateStatement(stmt);
+        for (self.tree.extraSlice(block.statements)) |stmt| {
+            if (self.tree.nodeAt(stmt).node_type == .variable_declaration) {
+                try saved.append(self.allocator, try self.generateVariableDeclaration(stmt));
+            } else {
+                try self.generateStatement(stmt);
+            }
         }
     }
 
-    fn generateReturnStatement(self: *Self, node: *ast.Node) CodeGenError!void {
-        const ret_stmt = node.data.return_statement;
+    fn generateReturnStatement(self: *Self, index: ast.NodeIndex) CodeGenError!void {
+        const ret_stmt = self.tree.nodeAt(index).data.return_statement;
 
-        if (ret_stmt.value) |value| {
-            const return_value = try self.generateExpression(value);
+        if (ret_stmt.value != ast.null_node) {
+            const return_value = try self.generateExpression(ret_stmt.value);
             _ = llvm.LLVMBuildRet(self.builder, return_value);
         } else {
             _ = llvm.LLVMBuildRetVoid(self.builder);
         }
     }
 
-    fn generateExpressionStatement(self: *Self, node: *ast.Node) CodeGenError!void {
-        const expr_stmt = node.data.expression_statement;
+    fn generateExpressionStatement(self: *Self, index: ast.NodeIndex) CodeGenError!void {
+        const expr_stmt = self.tree.nodeAt(index).data.expression_statement;
         _ = try self.generateExpression(expr_stmt.expression);
     }
 
-    fn generateIfStatement(self: *Self, node: *ast.Node) CodeGenError!void {
-        const if_stmt = node.data.if_statement;
+    fn generateIfStatement(self: *Self, index: ast.NodeIndex) CodeGenError!void {
+        const if_stmt = self.tree.nodeAt(index).data.if_statement;
 
         const condition = try self.generateExpression(if_stmt.condition);
 
         const function = self.current_function.?;
         const then_block = llvm.LLVMAppendBasicBlockInContext(self.context, function, "if.then");
-        const else_block = if (if_stmt.else_branch != null)
+        const else_block = if (if_stmt.else_branch != ast.null_node)
             llvm.LLVMAppendBasicBlockInContext(self.context, function, "if.else")
         else
             null;
@@ -314,10 +698,10 @@ pub const CodeGenerator = struct {
         }
 
         // Generate else block if it exists
-        if (if_stmt.else_branch) |else_branch| {
+        if (if_stmt.else_branch != ast.null_node) {
             const else_bb = else_block.?;
             llvm.LLVMPositionBuilderAtEnd(self.builder, else_bb);
-            try self.generateStatement(else_branch);
+            try self.generateStatement(if_stmt.else_branch);
             if (llvm.LLVMGetBasicBlockTerminator(else_bb) == null) {
                 _ = llvm.LLVMBuildBr(self.builder, merge_block);
             }
@@ -327,8 +711,8 @@ pub const CodeGenerator = struct {
         llvm.LLVMPositionBuilderAtEnd(self.builder, merge_block);
     }
 
-    fn generateWhileStatement(self: *Self, node: *ast.Node) CodeGenError!void {
-        const while_stmt = node.data.while_statement;
+    fn generateWhileStatement(self: *Self, index: ast.NodeIndex) CodeGenError!void {
+        const while_stmt = self.tree.nodeAt(index).data.while_statement;
 
         const function = self.current_function.?;
         const loop_block = llvm.LLVMAppendBasicBlockInContext(self.context, function, "while.cond");
@@ -354,38 +738,127 @@ pub const CodeGenerator = struct {
         llvm.LLVMPositionBuilderAtEnd(self.builder, end_block);
     }
 
-    fn generateExpression(self: *Self, node: *ast.Node) CodeGenError!llvm.LLVMValueRef {
-        return switch (node.node_type) {
-            .assignment_expression => self.generateAssignmentExpression(node),
-            .binary_expression => self.generateBinaryExpression(node),
-            .unary_expression => self.generateUnaryExpression(node),
-            .call_expression => self.generateCallExpression(node),
-            .identifier => self.generateIdentifier(node),
-            .number_literal => self.generateNumberLiteral(node),
-            .string_literal => self.generateStringLiteral(node),
-            .boolean_literal => self.generateBooleanLiteral(node),
+    // Ranged `for i in start..end`: both bounds are evaluated once in the
+    // preheader and the induction variable is a phi in the header — an SSA
+    // value from the first instruction, with no alloca waiting on mem2reg.
+    // The canonical count-up-by-one shape plus the llvm.loop hints on the
+    // back-edge is exactly what the vectorizer and unroller look for.
+    fn generateForStatement(self: *Self, index: ast.NodeIndex) CodeGenError!void {
+        const for_stmt = self.tree.nodeAt(index).data.for_statement;
+
+        const i32_type = llvm.LLVMInt32TypeInContext(self.context);
+        const start_value = try self.generateExpression(for_stmt.start);
+        const end_value = try self.generateExpression(for_stmt.end);
+
+        const function = self.current_function.?;
+        const preheader = llvm.LLVMGetInsertBlock(self.builder);
+        const cond_block = llvm.LLVMAppendBasicBlockInContext(self.context, function, "for.cond");
+        const body_block = llvm.LLVMAppendBasicBlockInContext(self.context, function, "for.body");
+        const end_block = llvm.LLVMAppendBasicBlockInContext(self.context, function, "for.end");
+
+        _ = llvm.LLVMBuildBr(self.builder, cond_block);
+
+        llvm.LLVMPositionBuilderAtEnd(self.builder, cond_block);
+        const induction = llvm.LLVMBuildPhi(self.builder, i32_type, for_stmt.name.ptr);
+        const condition = llvm.LLVMBuildICmp(self.builder, llvm.LLVMIntPredicate.LLVMIntSLT, induction, end_value, "for.cmp");
+        _ = llvm.LLVMBuildCondBr(self.builder, condition, body_block, end_block);
+
+        llvm.LLVMPositionBuilderAtEnd(self.builder, body_block);
+        const saved_induction = try self.bindLocal(for_stmt.symbol, .{
+            .value = induction,
+            .llvm_type = i32_type,
+            .is_alloca = false,
+        });
+        defer self.restoreLocal(saved_induction);
+        try self.generateStatement(for_stmt.body);
+
+        // Step and branch back unless the body already left the function
+        // (a return as the last statement); the phi only gets a back-edge
+        // incoming when the back-edge exists.
+        const latch = llvm.LLVMGetInsertBlock(self.builder);
+        if (llvm.LLVMGetBasicBlockTerminator(latch) == null) {
+            const one = llvm.LLVMConstInt(i32_type, 1, 0);
+            const next_value = llvm.LLVMBuildAdd(self.builder, induction, one, "for.next");
+            const back_edge = llvm.LLVMBuildBr(self.builder, cond_block);
+            const kind_id = llvm.LLVMGetMDKindIDInContext(self.context, "llvm.loop", "llvm.loop".len);
+            llvm.LLVMSetMetadata(back_edge, kind_id, self.loopMetadata());
+
+            var incoming_values = [_]llvm.LLVMValueRef{ start_value, next_value };
+            var incoming_blocks = [_]llvm.LLVMBasicBlockRef{ preheader, latch };
+            llvm.LLVMAddIncoming(induction, &incoming_values, &incoming_blocks, 2);
+        } else {
+            var incoming_values = [_]llvm.LLVMValueRef{start_value};
+            var incoming_blocks = [_]llvm.LLVMBasicBlockRef{preheader};
+            llvm.LLVMAddIncoming(induction, &incoming_values, &incoming_blocks, 1);
+        }
+
+        llvm.LLVMPositionBuilderAtEnd(self.builder, end_block);
+    }
+
+    // Loop identifier metadata for a for-loop back-edge: a self-referential
+    // node carrying llvm.loop.vectorize.enable and llvm.loop.unroll.enable.
+    // The C API cannot build the self-reference directly, so a temporary
+    // node stands in as the first operand and is RAUW'd with the finished
+    // node (which also frees the temporary).
+    fn loopMetadata(self: *Self) llvm.LLVMValueRef {
+        const vectorize_name = "llvm.loop.vectorize.enable";
+        const enabled = llvm.LLVMValueAsMetadata(llvm.LLVMConstInt(llvm.LLVMInt1TypeInContext(self.context), 1, 0));
+        var vectorize_ops = [_]llvm.LLVMMetadataRef{
+            llvm.LLVMMDStringInContext2(self.context, vectorize_name, vectorize_name.len),
+            enabled,
+        };
+        const vectorize = llvm.LLVMMDNodeInContext2(self.context, &vectorize_ops, vectorize_ops.len);
+
+        const unroll_name = "llvm.loop.unroll.enable";
+        var unroll_ops = [_]llvm.LLVMMetadataRef{
+            llvm.LLVMMDStringInContext2(self.context, unroll_name, unroll_name.len),
+        };
+        const unroll = llvm.LLVMMDNodeInContext2(self.context, &unroll_ops, unroll_ops.len);
+
+        const temp = llvm.LLVMTemporaryMDNode(self.context, null, 0);
+        var loop_ops = [_]llvm.LLVMMetadataRef{ temp, vectorize, unroll };
+        const loop_id = llvm.LLVMMDNodeInContext2(self.context, &loop_ops, loop_ops.len);
+        llvm.LLVMMetadataReplaceAllUsesWith(temp, loop_id);
+
+        return llvm.LLVMMetadataAsValue(self.context, loop_id);
+    }
+
+    fn generateExpression(self: *Self, index: ast.NodeIndex) CodeGenError!llvm.LLVMValueRef {
+        return switch (self.tree.nodeAt(index).node_type) {
+            .assignment_expression => self.generateAssignmentExpression(index),
+            .binary_expression => self.generateBinaryExpression(index),
+            .unary_expression => self.generateUnaryExpression(index),
+            .call_expression => self.generateCallExpression(index),
+            .identifier => self.generateIdentifier(index),
+            .number_literal => self.generateNumberLiteral(index),
+            .string_literal => self.generateStringLiteral(index),
+            .boolean_literal => self.generateBooleanLiteral(index),
             else => CodeGenError.InvalidOperation,
         };
     }
 
-    fn generateAssignmentExpression(self: *Self, node: *ast.Node) CodeGenError!llvm.LLVMValueRef {
-        const assign_expr = node.data.assignment_expression;
+    fn generateAssignmentExpression(self: *Self, index: ast.NodeIndex) CodeGenError!llvm.LLVMValueRef {
+        const assign_expr = self.tree.nodeAt(index).data.assignment_expression;
 
-        if (assign_expr.target.node_type != .identifier) {
+        if (self.tree.nodeAt(assign_expr.target).node_type != .identifier) {
             return CodeGenError.InvalidOperation;
         }
 
-        const var_name = assign_expr.target.data.identifier.name;
+        const target = self.tree.nodeAt(assign_expr.target).data.identifier;
         const value = try self.generateExpression(assign_expr.value);
 
-        const var_alloca = self.local_variables.get(var_name) orelse return CodeGenError.UndefinedVariable;
-        _ = llvm.LLVMBuildStore(self.builder, value, var_alloca);
+        const local = self.local_variables.get(target.symbol) orelse return CodeGenError.UndefinedVariable;
+        // The checker rejects assignment to immutable bindings, so an
+        // SSA-tracked local here is an internal invariant violation, not a
+        // user error.
+        if (!local.is_alloca) return CodeGenError.InvalidOperation;
+        _ = llvm.LLVMBuildStore(self.builder, value, local.value);
 
         return value;
     }
 
-    fn generateBinaryExpression(self: *Self, node: *ast.Node) CodeGenError!llvm.LLVMValueRef {
-        const bin_expr = node.data.binary_expression;
+    fn generateBinaryExpression(self: *Self, index: ast.NodeIndex) CodeGenError!llvm.LLVMValueRef {
+        const bin_expr = self.tree.nodeAt(index).data.binary_expression;
 
         const left = try self.generateExpression(bin_expr.left);
         const right = try self.generateExpression(bin_expr.right);
@@ -406,8 +879,8 @@ pub const CodeGenerator = struct {
         };
     }
 
-    fn generateUnaryExpression(self: *Self, node: *ast.Node) CodeGenError!llvm.LLVMValueRef {
-        const unary_expr = node.data.unary_expression;
+    fn generateUnaryExpression(self: *Self, index: ast.NodeIndex) CodeGenError!llvm.LLVMValueRef {
+        const unary_expr = self.tree.nodeAt(index).data.unary_expression;
 
         const operand = try self.generateExpression(unary_expr.operand);
 
@@ -417,21 +890,21 @@ pub const CodeGenerator = struct {
         };
     }
 
-    fn generateCallExpression(self: *Self, node: *ast.Node) CodeGenError!llvm.LLVMValueRef {
-        const call_expr = node.data.call_expression;
+    fn generateCallExpression(self: *Self, index: ast.NodeIndex) CodeGenError!llvm.LLVMValueRef {
+        const call_expr = self.tree.nodeAt(index).data.call_expression;
 
-        if (call_expr.function.node_type != .identifier) {
+        if (self.tree.nodeAt(call_expr.function).node_type != .identifier) {
             return CodeGenError.UndefinedFunction;
         }
 
-        const func_name = call_expr.function.data.identifier.name;
-        const function = self.functions.get(func_name) orelse return CodeGenError.UndefinedFunction;
+        const callee_symbol = self.tree.nodeAt(call_expr.function).data.identifier.symbol;
+        const function = self.functions.get(callee_symbol) orelse return CodeGenError.UndefinedFunction;
 
         // Generate arguments
         var args = std.ArrayList(llvm.LLVMValueRef).init(self.allocator);
         defer args.deinit();
 
-        for (call_expr.arguments) |arg| {
+        for (self.tree.extraSlice(call_expr.arguments)) |arg| {
             const arg_value = try self.generateExpression(arg);
             try args.append(arg_value);
         }
@@ -448,15 +921,16 @@ pub const CodeGenerator = struct {
         );
     }
 
-    fn generateIdentifier(self: *Self, node: *ast.Node) CodeGenError!llvm.LLVMValueRef {
-        const identifier = node.data.identifier;
+    fn generateIdentifier(self: *Self, index: ast.NodeIndex) CodeGenError!llvm.LLVMValueRef {
+        const identifier = self.tree.nodeAt(index).data.identifier;
 
-        const var_alloca = self.local_variables.get(identifier.name) orelse return CodeGenError.UndefinedVariable;
-        return llvm.LLVMBuildLoad2(self.builder, llvm.LLVMInt32TypeInContext(self.context), var_alloca, identifier.name.ptr);
+        const local = self.local_variables.get(identifier.symbol) orelse return CodeGenError.UndefinedVariable;
+        if (!local.is_alloca) return local.value;
+        return llvm.LLVMBuildLoad2(self.builder, local.llvm_type, local.value, identifier.name.ptr);
     }
 
-    fn generateNumberLiteral(self: *Self, node: *ast.Node) CodeGenError!llvm.LLVMValueRef {
-        const num_literal = node.data.number_literal;
+    fn generateNumberLiteral(self: *Self, index: ast.NodeIndex) CodeGenError!llvm.LLVMValueRef {
+        const num_literal = self.tree.nodeAt(index).data.number_literal;
 
         if (num_literal.is_integer) {
             const int_val = @as(i32, @intFromFloat(num_literal.value));
@@ -466,17 +940,38 @@ pub const CodeGenerator = struct {
         }
     }
 
-    fn generateStringLiteral(self: *Self, node: *ast.Node) CodeGenError!llvm.LLVMValueRef {
-        const str_literal = node.data.string_literal;
-
-        const str_name = try std.fmt.allocPrintZ(self.allocator, ".str.{d}", .{@intFromPtr(node)});
-        defer self.allocator.free(str_name);
+    fn generateStringLiteral(self: *Self, index: ast.NodeIndex) CodeGenError!llvm.LLVMValueRef {
+        const str_literal = self.tree.nodeAt(index).data.string_literal;
+        return self.stringConstant(str_literal.value);
+    }
 
-        return llvm.LLVMBuildGlobalStringPtr(self.builder, str_literal.value.ptr, str_name.ptr);
+    // Emit a string global for `content` once and hand the same pointer to
+    // every later use. Globals used to be named by node index, so repeated
+    // literals each got their own copy in rodata; now the name is a table
+    // ordinal and the content is the identity.
+    fn stringConstant(self: *Self, content: []const u8) CodeGenError!llvm.LLVMValueRef {
+        if (self.string_globals.get(content)) |global| return global;
+
+        var name_buf: [24]u8 = undefined;
+        const str_name = std.fmt.bufPrintZ(&name_buf, ".str.{d}", .{self.string_globals.count()}) catch unreachable;
+
+        // The content is a view into the source buffer, so the byte after
+        // it is the closing quote, not a NUL — the initializer must be
+        // built from the explicit length, never strlen'd. The trailing NUL
+        // the runtime expects is appended by LLVMConstStringInContext.
+        const initializer = llvm.LLVMConstStringInContext(self.context, content.ptr, @intCast(content.len), 0);
+        const global = llvm.LLVMAddGlobal(self.module, llvm.LLVMTypeOf(initializer), str_name.ptr);
+        llvm.LLVMSetInitializer(global, initializer);
+        llvm.LLVMSetGlobalConstant(global, 1);
+        llvm.LLVMSetLinkage(global, llvm.LLVMLinkage.LLVMPrivateLinkage);
+        llvm.LLVMSetUnnamedAddress(global, llvm.LLVMUnnamedAddr.LLVMGlobalUnnamedAddr);
+
+        try self.string_globals.put(content, global);
+        return global;
     }
 
-    fn generateBooleanLiteral(self: *Self, node: *ast.Node) CodeGenError!llvm.LLVMValueRef {
-        const bool_literal = node.data.boolean_literal;
+    fn generateBooleanLiteral(self: *Self, index: ast.NodeIndex) CodeGenError!llvm.LLVMValueRef {
+        const bool_literal = self.tree.nodeAt(index).data.boolean_literal;
         return llvm.LLVMConstInt(llvm.LLVMInt1TypeInContext(self.context), if (bool_literal.value) 1 else 0, 0);
     }
 
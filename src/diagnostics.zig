@@ -0,0 +1,94 @@
+const std = @import("std");
+const ast = @import("ast.zig");
+
+// Accumulated diagnostics for one compile. The parser and checker used to
+// print and abort on the first problem, so an N-error file cost N compile
+// runs; they now record everything they find here and keep going, and the
+// whole batch is sorted by source position and flushed once with source
+// context at the end of the phase.
+pub const Diagnostic = struct {
+    position: ast.Position,
+    // Owned by the list's allocator.
+    message: []const u8,
+};
+
+pub const DiagnosticList = struct {
+    const Self = @This();
+
+    allocator: std.mem.Allocator,
+    items: std.ArrayList(Diagnostic) = .{},
+
+    pub fn init(allocator: std.mem.Allocator) Self {
+        return Self{ .allocator = allocator };
+    }
+
+    pub fn deinit(self: *Self) void {
+        for (self.items.items) |diagnostic| {
+            self.allocator.free(diagnostic.message);
+        }
+        self.items.deinit(self.allocator);
+    }
+
+    pub fn add(self: *Self, position: ast.Position, comptime fmt: []const u8, args: anytype) !void {
+        const message = try std.fmt.allocPrint(self.allocator, fmt, args);
+        errdefer self.allocator.free(message);
+        try self.items.append(self.allocator, .{ .position = position, .message = message });
+    }
+
+    pub fn count(self: *const Self) usize {
+        return self.items.items.len;
+    }
+
+    // Move every diagnostic out of `other` into this list; used to merge
+    // per-worker batches from the parallel checker back into the parent.
+    pub fn adopt(self: *Self, other: *Self) void {
+        self.items.appendSlice(self.allocator, other.items.items) catch return;
+        other.items.clearRetainingCapacity();
+    }
+
+    // Sort by source position and write the whole batch to stderr in one
+    // buffered write, quoting the offending line with a caret under the
+    // reported column when `source` is available.
+    pub fn flush(self: *Self, source: []const u8) void {
+        std.mem.sort(Diagnostic, self.items.items, {}, positionLessThan);
+
+        var text = std.ArrayList(u8){};
+        defer text.deinit(self.allocator);
+
+        // Diagnostics are sorted, so one forward scan over the source
+        // finds every quoted line.
+        var lines = std.mem.splitScalar(u8, source, '\n');
+        var current_line: u32 = 0;
+        var line_text: []const u8 = "";
+
+        for (self.items.items) |diagnostic| {
+            self.append(&text, "{d}:{d}: error: {s}\n", .{ diagnostic.position.line, diagnostic.position.column, diagnostic.message });
+
+            while (current_line < diagnostic.position.line) {
+                line_text = std.mem.trimRight(u8, lines.next() orelse break, "\r");
+                current_line += 1;
+            }
+            if (current_line == diagnostic.position.line and diagnostic.position.line > 0) {
+                self.append(&text, "    {s}\n    ", .{line_text});
+                const caret_column = @min(@as(usize, diagnostic.position.column), line_text.len + 1);
+                for (1..caret_column) |_| {
+                    text.append(self.allocator, ' ') catch break;
+                }
+                self.append(&text, "^\n", .{});
+            }
+        }
+
+        std.fs.File.stderr().writeAll(text.items) catch {};
+    }
+
+    fn append(self: *Self, text: *std.ArrayList(u8), comptime fmt: []const u8, args: anytype) void {
+        const piece = std.fmt.allocPrint(self.allocator, fmt, args) catch return;
+        defer self.allocator.free(piece);
+        text.appendSlice(self.allocator, piece) catch {};
+    }
+
+    fn positionLessThan(_: void, a: Diagnostic, b: Diagnostic) bool {
+        if (a.position.line != b.position.line) return a.position.line < b.position.line;
+        return a.position.column < b.position.column;
+    }
+};
@@ -0,0 +1,286 @@
+const std = @import("std");
+const ast = @import("ast.zig");
+const intern = @import("intern.zig");
+
+// Constant folding pass, run between type checking and code generation.
+// Binary and unary expressions whose operands are literals are evaluated
+// and rewritten in place as literal nodes, and `const` bindings whose
+// initializer folded to a literal are propagated into later uses. The
+// flat tree makes the rewrite a single store into the node array; no
+// nodes are allocated or freed. Codegen then walks a smaller tree and
+// emits no instructions at all for literal arithmetic, which otherwise
+// executes at -O0.
+pub fn foldProgram(allocator: std.mem.Allocator, tree: *ast.Ast) !void {
+    var folder = ConstantFolder{ .allocator = allocator, .tree = tree };
+    defer folder.deinit();
+
+    const program = tree.nodeAt(tree.root);
+    for (tree.extraSlice(program.data.program.statements)) |statement| {
+        try folder.foldStatement(statement);
+    }
+}
+
+const Literal = union(enum) {
+    number: ast.NumberLiteral,
+    boolean: bool,
+};
+
+// One visible binding. A null value means the name is known but not
+// propagatable (`let`, a parameter, or a const with an unfoldable
+// initializer); the backward scan stops there, so shadowing masks an
+// outer const the same way it does in the checker's scope stack.
+const Binding = struct {
+    symbol: intern.Symbol,
+    value: ?Literal,
+};
+
+const ConstantFolder = struct {
+    const Self = @This();
+
+    allocator: std.mem.Allocator,
+    tree: *ast.Ast,
+    bindings: std.ArrayList(Binding) = .{},
+    scope_marks: std.ArrayList(u32) = .{},
+
+    fn deinit(self: *Self) void {
+        self.bindings.deinit(self.allocator);
+        self.scope_marks.deinit(self.allocator);
+    }
+
+    fn pushScope(self: *Self) !void {
+        try self.scope_marks.append(self.allocator, @intCast(self.bindings.items.len));
+    }
+
+    fn popScope(self: *Self) void {
+        const mark = self.scope_marks.pop().?;
+        self.bindings.shrinkRetainingCapacity(mark);
+    }
+
+    fn define(self: *Self, symbol: intern.Symbol, value: ?Literal) !void {
+        try self.bindings.append(self.allocator, .{ .symbol = symbol, .value = value });
+    }
+
+    fn lookup(self: *Self, symbol: intern.Symbol) ?Literal {
+        var i = self.bindings.items.len;
+        while (i > 0) {
+            i -= 1;
+            const binding = self.bindings.items[i];
+            if (binding.symbol == symbol) return binding.value;
+        }
+        return null;
+    }
+
+    fn foldStatement(self: *Self, index: ast.NodeIndex) !void {
+        const node = self.tree.nodeAt(index);
+        switch (node.node_type) {
+            .function_declaration => {
+                const func_decl = node.data.function_declaration;
+                try self.pushScope();
+                defer self.popScope();
+                // Parameters are runtime values; they shadow any outer
+                // const of the same name.
+                for (func_decl.parameters) |param| {
+                    try self.define(param.symbol, null);
+                }
+                try self.foldStatement(func_decl.body);
+            },
+            .variable_declaration => {
+                const var_decl = node.data.variable_declaration;
+                var value: ?Literal = null;
+                if (var_decl.initializer != ast.null_node) {
+                    try self.foldExpression(var_decl.initializer);
+                    if (!var_decl.is_mutable) {
+                        value = self.literalOf(var_decl.initializer);
+                    }
+                }
+                try self.define(var_decl.symbol, value);
+            },
+            .block_statement => {
+                try self.pushScope();
+                defer self.popScope();
+                for (self.tree.extraSlice(node.data.block_statement.statements)) |statement| {
+                    try self.foldStatement(statement);
+                }
+            },
+            .return_statement => {
+                if (node.data.return_statement.value != ast.null_node) {
+                    try self.foldExpression(node.data.return_statement.value);
+                }
+            },
+            .expression_statement => {
+                try self.foldExpression(node.data.expression_statement.expression);
+            },
+            .if_statement => {
+                const if_stmt = node.data.if_statement;
+                try self.foldExpression(if_stmt.condition);
+                try self.foldStatement(if_stmt.then_branch);
+                if (if_stmt.else_branch != ast.null_node) {
+                    try self.foldStatement(if_stmt.else_branch);
+                }
+            },
+            .while_statement => {
+                const while_stmt = node.data.while_statement;
+                try self.foldExpression(while_stmt.condition);
+                try self.foldStatement(while_stmt.body);
+            },
+            .for_statement => {
+                const for_stmt = node.data.for_statement;
+                try self.foldExpression(for_stmt.start);
+                try self.foldExpression(for_stmt.end);
+                try self.pushScope();
+                defer self.popScope();
+                // The induction variable changes every iteration; never a
+                // candidate for propagation.
+                try self.define(for_stmt.symbol, null);
+                try self.foldStatement(for_stmt.body);
+            },
+            else => try self.foldExpression(index),
+        }
+    }
+
+    fn foldExpression(self: *Self, index: ast.NodeIndex) (std.mem.Allocator.Error)!void {
+        const node = self.tree.nodeAt(index);
+        switch (node.node_type) {
+            .binary_expression => {
+                const bin_expr = node.data.binary_expression;
+                try self.foldExpression(bin_expr.left);
+                try self.foldExpression(bin_expr.right);
+
+                const left = self.literalOf(bin_expr.left) orelse return;
+                const right = self.literalOf(bin_expr.right) orelse return;
+                if (evalBinary(bin_expr.operator, left, right)) |result| {
+                    self.rewrite(index, result);
+                }
+            },
+            .unary_expression => {
+                const unary_expr = node.data.unary_expression;
+                try self.foldExpression(unary_expr.operand);
+
+                const operand = self.literalOf(unary_expr.operand) orelse return;
+                if (evalUnary(unary_expr.operator, operand)) |result| {
+                    self.rewrite(index, result);
+                }
+            },
+            .identifier => {
+                if (self.lookup(node.data.identifier.symbol)) |value| {
+                    self.rewrite(index, value);
+                }
+            },
+            .call_expression => {
+                for (self.tree.extraSlice(node.data.call_expression.arguments)) |argument| {
+                    try self.foldExpression(argument);
+                }
+            },
+            .assignment_expression => {
+                // The target stays an identifier; the checker rejects
+                // stores to `const`, so only `let` variables are assignable
+                // and those are never propagated — a recorded literal can't
+                // be invalidated by a later store.
+                try self.foldExpression(node.data.assignment_expression.value);
+            },
+            else => {},
+        }
+    }
+
+    fn literalOf(self: *Self, index: ast.NodeIndex) ?Literal {
+        const node = self.tree.nodeAt(index);
+        return switch (node.node_type) {
+            .number_literal => .{ .number = node.data.number_literal },
+            .boolean_literal => .{ .boolean = node.data.boolean_literal.value },
+            else => null,
+        };
+    }
+
+    fn rewrite(self: *Self, index: ast.NodeIndex, value: Literal) void {
+        const position = self.tree.nodeAt(index).position;
+        self.tree.nodes.items[index] = switch (value) {
+            .number => |number| ast.Node{
+                .node_type = .number_literal,
+                .position = position,
+                .data = .{ .number_literal = number },
+            },
+            .boolean => |boolean| ast.Node{
+                .node_type = .boolean_literal,
+                .position = position,
+                .data = .{ .boolean_literal = .{ .value = boolean } },
+            },
+        };
+    }
+};
+
+// Evaluates one binary operation over literals, or null when the
+// combination doesn't fold: mixed operand kinds, or integer division by
+// zero, which is left for the runtime rather than given a value here.
+fn evalBinary(operator: ast.BinaryOperator, left: Literal, right: Literal) ?Literal {
+    switch (operator) {
+        .add, .subtract, .multiply, .divide => {
+            if (left != .number or right != .number) return null;
+            const l = left.number;
+            const r = right.number;
+            const is_integer = l.is_integer and r.is_integer;
+            const value = switch (operator) {
+                .add => l.value + r.value,
+                .subtract => l.value - r.value,
+                .multiply => l.value * r.value,
+                .divide => blk: {
+                    if (is_integer) {
+                        if (r.value == 0) return null;
+                        // Truncating division matches the sdiv codegen emits.
+                        break :blk @divTrunc(l.value, r.value);
+                    }
+                    break :blk l.value / r.value;
+                },
+                else => unreachable,
+            };
+            // An integer result outside i32 range is left for the runtime
+            // (a wrapping add today), same as division by zero: folding
+            // must never reject or crash on code the backend accepts.
+            if (is_integer and (value < std.math.minInt(i32) or value > std.math.maxInt(i32))) return null;
+            return .{ .number = .{ .value = value, .is_integer = is_integer } };
+        },
+        .less_than, .less_equal, .greater_than, .greater_equal => {
+            if (left != .number or right != .number) return null;
+            const l = left.number.value;
+            const r = right.number.value;
+            return .{ .boolean = switch (operator) {
+                .less_than => l < r,
+                .less_equal => l <= r,
+                .greater_than => l > r,
+                .greater_equal => l >= r,
+                else => unreachable,
+            } };
+        },
+        .equal, .not_equal => {
+            const result = switch (left) {
+                .number => |l| if (right == .number) l.value == right.number.value else return null,
+                .boolean => |l| if (right == .boolean) l == right.boolean else return null,
+            };
+            return .{ .boolean = if (operator == .equal) result else !result };
+        },
+        .logical_and, .logical_or => {
+            if (left != .boolean or right != .boolean) return null;
+            return .{ .boolean = switch (operator) {
+                .logical_and => left.boolean and right.boolean,
+                .logical_or => left.boolean or right.boolean,
+                else => unreachable,
+            } };
+        },
+    }
+}
+
+fn evalUnary(operator: ast.UnaryOperator, operand: Literal) ?Literal {
+    switch (operator) {
+        .minus => {
+            if (operand != .number) return null;
+            const value = -operand.number.value;
+            // Same range policy as evalBinary: -(-2147483648) has no i32
+            // result, so leave it to the runtime.
+            if (operand.number.is_integer and value > std.math.maxInt(i32)) return null;
+            return .{ .number = .{ .value = value, .is_integer = operand.number.is_integer } };
+        },
+        .logical_not => {
+            if (operand != .boolean) return null;
+            return .{ .boolean = !operand.boolean };
+        },
+    }
+}
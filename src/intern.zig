@@ -0,0 +1,61 @@
+const std = @import("std");
+
+pub const Symbol = u32;
+
+// Sentinel for tokens that carry no interned name (everything except
+// identifiers).
+pub const no_symbol: Symbol = std.math.maxInt(Symbol);
+
+// Global string interner. Identifier names used to flow through the whole
+// pipeline as []const u8 slices and get re-hashed by every table they
+// touched: the type environment, then the codegen local and function maps.
+// The interner hashes each distinct spelling exactly once, while the lexer
+// scans it, and hands out a dense u32 symbol ID that the later phases use
+// as an integer map key, turning their hottest lookups into int hashing or
+// plain array indexing.
+pub const StringInterner = struct {
+    const Self = @This();
+
+    allocator: std.mem.Allocator,
+    map: std.StringHashMap(Symbol),
+    names: std.ArrayList([]const u8),
+
+    pub fn init(allocator: std.mem.Allocator) Self {
+        return Self{
+            .allocator = allocator,
+            .map = std.StringHashMap(Symbol).init(allocator),
+            .names = std.ArrayList([]const u8){},
+        };
+    }
+
+    pub fn deinit(self: *Self) void {
+        self.map.deinit();
+        self.names.deinit(self.allocator);
+    }
+
+    // `text` is not copied and must outlive the interner; in practice it is
+    // a slice of the source buffer or a static string.
+    pub fn intern(self: *Self, text: []const u8) !Symbol {
+        const entry = try self.map.getOrPut(text);
+        if (!entry.found_existing) {
+            entry.value_ptr.* = @intCast(self.names.items.len);
+            try self.names.append(self.allocator, text);
+        }
+        return entry.value_ptr.*;
+    }
+
+    // Read-only lookup. intern() can grow and rehash the table even when
+    // the key already exists, so threads sharing an interner must resolve
+    // already-interned spellings through here instead.
+    pub fn find(self: *const Self, text: []const u8) ?Symbol {
+        return self.map.get(text);
+    }
+
+    pub fn name(self: *const Self, symbol: Symbol) []const u8 {
+        return self.names.items[symbol];
+    }
+
+    pub fn count(self: *const Self) usize {
+        return self.names.items.len;
+    }
+};
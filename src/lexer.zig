@@ -1,4 +1,5 @@
 const std = @import("std");
+const intern = @import("intern.zig");
 
 pub const TokenType = enum {
     // Keywords
@@ -10,6 +11,7 @@ pub const TokenType = enum {
     else_,
     while_,
     for_,
+    in_,
     true_,
     false_,
 
@@ -48,6 +50,7 @@ pub const TokenType = enum {
     semicolon,
     colon,
     arrow, // ->
+    dot_dot, // ..
 
     // Special
     eof,
@@ -65,6 +68,7 @@ pub const TokenType = enum {
             .else_ => "else",
             .while_ => "while",
             .for_ => "for",
+            .in_ => "in",
             .true_ => "true",
             .false_ => "false",
             .i32 => "i32",
@@ -95,6 +99,7 @@ pub const TokenType = enum {
             .semicolon => ";",
             .colon => ":",
             .arrow => "->",
+            .dot_dot => "..",
             .eof => "EOF",
             .error_ => "ERROR",
             .newline => "NEWLINE",
@@ -110,6 +115,185 @@ pub const Token = struct {
     column: u32,
 };
 
+pub const LineCol = struct {
+    line: u32,
+    column: u32,
+};
+
+// Struct-of-arrays token storage. A materialized Token is 32 bytes, most of
+// which stays cold while the parser switches on TokenType; here a token costs
+// one TokenType byte plus a u32 start offset. Lexemes and line/column are
+// recomputed from the offsets on demand, so the parser's working set is the
+// dense `types` array.
+pub const TokenBuffer = struct {
+    source: []const u8,
+    types: []TokenType,
+    starts: []u32,
+    // Interned symbol ID per token; intern.no_symbol for non-identifiers.
+    symbols: []intern.Symbol,
+    // Byte offset of the first character of each line, for binary-searched
+    // line/column lookup.
+    line_starts: []u32,
+
+    pub fn deinit(self: *TokenBuffer, allocator: std.mem.Allocator) void {
+        allocator.free(self.types);
+        allocator.free(self.starts);
+        allocator.free(self.symbols);
+        allocator.free(self.line_starts);
+    }
+
+    pub fn len(self: *const TokenBuffer) usize {
+        return self.types.len;
+    }
+
+    // Recompute the lexeme of a token from its start offset. Fixed-spelling
+    // tokens (keywords, operators, punctuation) have their length encoded in
+    // TokenType.toString; only identifiers, numbers, and strings are rescanned.
+    pub fn lexeme(self: *const TokenBuffer, index: usize) []const u8 {
+        return lexemeFrom(self.source, self.types[index], self.starts[index]);
+    }
+
+    pub fn lineCol(self: *const TokenBuffer, index: usize) LineCol {
+        return lineColFrom(self.line_starts, self.starts[index]);
+    }
+
+    // Materialize a full Token, for diagnostics and debugging.
+    pub fn get(self: *const TokenBuffer, index: usize) Token {
+        const pos = self.lineCol(index);
+        return Token{
+            .type = self.types[index],
+            .lexeme = self.lexeme(index),
+            .line = pos.line,
+            .column = pos.column,
+        };
+    }
+};
+
+// Recompute a lexeme from a token's type and start offset, shared by
+// TokenBuffer and TokenStream.
+pub fn lexemeFrom(source: []const u8, token_type: TokenType, start: u32) []const u8 {
+    switch (token_type) {
+        .identifier => {
+            return source[start..Lexer.alnumRunEnd(source, start)];
+        },
+        .number => {
+            var end = Lexer.digitRunEnd(source, start);
+            if (end + 1 < source.len and source[end] == '.' and Lexer.isDigit(source[end + 1])) {
+                end = Lexer.digitRunEnd(source, end + 1);
+            }
+            return source[start..end];
+        },
+        .string_literal => {
+            // `start` is the opening quote; the stored value excludes both quotes.
+            const close = std.mem.indexOfScalarPos(u8, source, start + 1, '"') orelse source.len;
+            return source[start + 1 .. close];
+        },
+        .eof, .error_ => return "",
+        else => {
+            const text = token_type.toString();
+            return source[start .. start + text.len];
+        },
+    }
+}
+
+// Binary search for the last line start <= offset.
+pub fn lineColFrom(line_starts: []const u32, offset: u32) LineCol {
+    var lo: usize = 0;
+    var hi: usize = line_starts.len;
+    while (hi - lo > 1) {
+        const mid = lo + (hi - lo) / 2;
+        if (line_starts[mid] <= offset) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return LineCol{
+        .line = @intCast(lo + 1),
+        .column = offset - line_starts[lo] + 1,
+    };
+}
+
+// A token as handed out by the streaming front end: just the tag and the
+// start offset, the same five bytes per token TokenBuffer stores.
+pub const StreamedToken = struct {
+    type: TokenType,
+    start: u32,
+    // Interned symbol for identifiers, intern.no_symbol otherwise.
+    symbol: intern.Symbol = intern.no_symbol,
+};
+
+// Pull-based streaming front end. Instead of materializing the whole token
+// array before parsing starts, the parser requests tokens one at a time and
+// the lexer scans just far enough to satisfy lookahead, so lexing overlaps
+// parsing and peak memory no longer includes a full token buffer. A small
+// ring holds pending lookahead.
+pub const TokenStream = struct {
+    const Self = @This();
+
+    // Power of two, and comfortably more than the parser ever peeks ahead.
+    const lookahead_len = 8;
+
+    lexer: *Lexer,
+    ring: [lookahead_len]StreamedToken,
+    head: usize,
+    count: usize,
+
+    pub fn init(lexer_instance: *Lexer) Self {
+        return Self{
+            .lexer = lexer_instance,
+            .ring = undefined,
+            .head = 0,
+            .count = 0,
+        };
+    }
+
+    pub fn peek(self: *Self, distance: usize) LexerError!StreamedToken {
+        std.debug.assert(distance < lookahead_len);
+        while (self.count <= distance) {
+            self.ring[(self.head + self.count) % lookahead_len] = try self.scanNext();
+            self.count += 1;
+        }
+        return self.ring[(self.head + distance) % lookahead_len];
+    }
+
+    pub fn advance(self: *Self) LexerError!StreamedToken {
+        const token = try self.peek(0);
+        self.head = (self.head + 1) % lookahead_len;
+        self.count -= 1;
+        return token;
+    }
+
+    pub fn source(self: *const Self) []const u8 {
+        return self.lexer.source;
+    }
+
+    // Line starts recorded so far; complete for every token already handed out.
+    pub fn lineStarts(self: *const Self) []const u32 {
+        return self.lexer.line_starts.items;
+    }
+
+    fn scanNext(self: *Self) LexerError!StreamedToken {
+        const lx = self.lexer;
+        if (lx.current == 0 and lx.line_starts.items.len == 0) {
+            try lx.line_starts.append(lx.allocator, 0);
+        }
+        while (!lx.isAtEnd()) {
+            lx.start = lx.current;
+            lx.last_symbol = intern.no_symbol;
+            if (try lx.scanToken()) |token_type| {
+                return StreamedToken{
+                    .type = token_type,
+                    .start = @intCast(lx.start),
+                    .symbol = lx.last_symbol,
+                };
+            }
+        }
+        return StreamedToken{ .type = .eof, .start = @intCast(lx.source.len) };
+    }
+};
+
 pub const LexerError = error{
     UnterminatedString,
     InvalidCharacter,
@@ -121,119 +305,137 @@ pub const Lexer = struct {
 
     allocator: std.mem.Allocator,
     source: []const u8,
-    tokens: std.ArrayList(Token),
+    interner: *intern.StringInterner,
+    types: std.ArrayList(TokenType),
+    starts: std.ArrayList(u32),
+    symbols: std.ArrayList(intern.Symbol),
+    line_starts: std.ArrayList(u32),
     start: usize,
     current: usize,
-    line: u32,
-    column: u32,
+    // Symbol interned by the most recent scanIdentifier, picked up by
+    // whichever consumer records the token.
+    last_symbol: intern.Symbol,
 
-    pub fn init(allocator: std.mem.Allocator, source: []const u8) Self {
+    pub fn init(allocator: std.mem.Allocator, source: []const u8, interner: *intern.StringInterner) Self {
         return Self{
             .allocator = allocator,
             .source = source,
-            .tokens = std.ArrayList(Token){},
+            .interner = interner,
+            .types = std.ArrayList(TokenType){},
+            .starts = std.ArrayList(u32){},
+            .symbols = std.ArrayList(intern.Symbol){},
+            .line_starts = std.ArrayList(u32){},
             .start = 0,
             .current = 0,
-            .line = 1,
-            .column = 1,
+            .last_symbol = intern.no_symbol,
         };
     }
 
     pub fn deinit(self: *Self) void {
-        self.tokens.deinit(self.allocator);
+        self.types.deinit(self.allocator);
+        self.starts.deinit(self.allocator);
+        self.symbols.deinit(self.allocator);
+        self.line_starts.deinit(self.allocator);
     }
 
-    pub fn tokenize(self: *Self) ![]Token {
+    pub fn tokenize(self: *Self) !TokenBuffer {
+        try self.line_starts.append(self.allocator, 0);
+
         while (!self.isAtEnd()) {
             self.start = self.current;
-            try self.scanToken();
+            self.last_symbol = intern.no_symbol;
+            if (try self.scanToken()) |token_type| {
+                try self.types.append(self.allocator, token_type);
+                try self.starts.append(self.allocator, @intCast(self.start));
+                try self.symbols.append(self.allocator, self.last_symbol);
+            }
         }
 
-        try self.tokens.append(self.allocator, Token{
-            .type = .eof,
-            .lexeme = "",
-            .line = self.line,
-            .column = self.column,
-        });
+        try self.types.append(self.allocator, .eof);
+        try self.starts.append(self.allocator, @intCast(self.source.len));
+        try self.symbols.append(self.allocator, intern.no_symbol);
 
-        return self.tokens.toOwnedSlice(self.allocator);
+        return TokenBuffer{
+            .source = self.source,
+            .types = try self.types.toOwnedSlice(self.allocator),
+            .starts = try self.starts.toOwnedSlice(self.allocator),
+            .symbols = try self.symbols.toOwnedSlice(self.allocator),
+            .line_starts = try self.line_starts.toOwnedSlice(self.allocator),
+        };
     }
 
     fn isAtEnd(self: *Self) bool {
         return self.current >= self.source.len;
     }
 
-    fn scanToken(self: *Self) !void {
+    // Scans one lexeme starting at self.start. Returns the token's type, or
+    // null when the lexeme produces no token (whitespace, comments,
+    // newlines). Callers decide whether the result is appended to a
+    // TokenBuffer or handed out through a TokenStream.
+    fn scanToken(self: *Self) LexerError!?TokenType {
         const c = self.advance();
 
         switch (c) {
             ' ', '\r', '\t' => {
-                // Skip whitespace
+                // Skip the whole whitespace run, not just this byte.
+                // '\n' is excluded so the newline case below keeps the
+                // line table accurate.
+                self.current = whitespaceRunEnd(self.source, self.current);
+                return null;
             },
             '\n' => {
-                self.line += 1;
-                self.column = 1;
+                try self.line_starts.append(self.allocator, @intCast(self.current));
+                return null;
+            },
+            '(' => return .left_paren,
+            ')' => return .right_paren,
+            '{' => return .left_brace,
+            '}' => return .right_brace,
+            ',' => return .comma,
+            ';' => return .semicolon,
+            ':' => return .colon,
+            '.' => {
+                // Only the range operator; a bare '.' never starts a token
+                // (fractional parts are consumed inside scanNumber).
+                if (self.match('.')) return .dot_dot;
+                return LexerError.InvalidCharacter;
             },
-            '(' => try self.addToken(.left_paren),
-            ')' => try self.addToken(.right_paren),
-            '{' => try self.addToken(.left_brace),
-            '}' => try self.addToken(.right_brace),
-            ',' => try self.addToken(.comma),
-            ';' => try self.addToken(.semicolon),
-            ':' => try self.addToken(.colon),
-            '+' => try self.addToken(.plus),
-            '*' => try self.addToken(.star),
+            '+' => return .plus,
+            '*' => return .star,
             '/' => {
                 if (self.match('/')) {
                     // Line comment - skip until end of line
-                    while (self.peek() != '\n' and !self.isAtEnd()) {
-                        _ = self.advance();
-                    }
-                } else {
-                    try self.addToken(.slash);
+                    self.current = lineEnd(self.source, self.current);
+                    return null;
                 }
+                return .slash;
             },
             '-' => {
-                if (self.match('>')) {
-                    try self.addToken(.arrow);
-                } else {
-                    try self.addToken(.minus);
-                }
+                if (self.match('>')) return .arrow;
+                return .minus;
             },
             '!' => {
-                if (self.match('=')) {
-                    try self.addToken(.bang_equal);
-                } else {
-                    try self.addToken(.bang);
-                }
+                if (self.match('=')) return .bang_equal;
+                return .bang;
             },
             '=' => {
-                if (self.match('=')) {
-                    try self.addToken(.equal_equal);
-                } else {
-                    try self.addToken(.equal);
-                }
+                if (self.match('=')) return .equal_equal;
+                return .equal;
             },
             '<' => {
-                if (self.match('=')) {
-                    try self.addToken(.less_equal);
-                } else {
-                    try self.addToken(.less);
-                }
+                if (self.match('=')) return .less_equal;
+                return .less;
             },
             '>' => {
-                if (self.match('=')) {
-                    try self.addToken(.greater_equal);
-                } else {
-                    try self.addToken(.greater);
-                }
+                if (self.match('=')) return .greater_equal;
+                return .greater;
             },
-            '"' => try self.scanString(),
+            '"' => return try self.scanString(),
             else => {
                 if (isDigit(c)) {
-                    try self.scanNumber();
+                    return self.scanNumber();
                 } else if (isAlpha(c)) {
-                    try self.scanIdentifier();
+                    return try self.scanIdentifier();
                 } else {
                     return LexerError.InvalidCharacter;
                 }
@@ -242,7 +444,6 @@ pub const Lexer = struct {
     }
 
     fn advance(self: *Self) u8 {
-        self.column += 1;
         const c = self.source[self.current];
         self.current += 1;
         return c;
@@ -253,7 +454,6 @@ pub const Lexer = struct {
         if (self.source[self.current] != expected) return false;
 
         self.current += 1;
-        self.column += 1;
         return true;
     }
 
@@ -267,15 +467,14 @@ pub const Lexer = struct {
         return self.source[self.current + 1];
     }
 
-    fn scanString(self: *Self) !void {
+    fn scanString(self: *Self) LexerError!TokenType {
         while (self.peek() != '"' and !self.isAtEnd()) {
             if (self.peek() == '\n') {
-                self.line += 1;
-                self.column = 1;
+                _ = self.advance();
+                try self.line_starts.append(self.allocator, @intCast(self.current));
             } else {
-                self.column += 1;
+                _ = self.advance();
             }
-            _ = self.advance();
         }
 
         if (self.isAtEnd()) {
@@ -285,51 +484,119 @@ pub const Lexer = struct {
         // Closing "
         _ = self.advance();
 
-        // Trim the surrounding quotes
-        const value = self.source[self.start + 1 .. self.current - 1];
-        try self.addTokenWithLexeme(.string_literal, value);
+        // The start offset keeps the opening quote; lexemeFrom trims the
+        // surrounding quotes when the value is requested.
+        return .string_literal;
     }
 
-    fn scanNumber(self: *Self) !void {
-        while (isDigit(self.peek())) {
-            _ = self.advance();
-        }
+    fn scanNumber(self: *Self) TokenType {
+        self.current = digitRunEnd(self.source, self.current);
 
         // Look for fractional part
         if (self.peek() == '.' and isDigit(self.peekNext())) {
             // Consume the "."
             _ = self.advance();
-
-            while (isDigit(self.peek())) {
-                _ = self.advance();
-            }
+            self.current = digitRunEnd(self.source, self.current);
         }
 
-        try self.addToken(.number);
+        return .number;
     }
 
-    fn scanIdentifier(self: *Self) !void {
-        while (isAlphaNumeric(self.peek())) {
-            _ = self.advance();
-        }
+    fn scanIdentifier(self: *Self) LexerError!TokenType {
+        self.current = alnumRunEnd(self.source, self.current);
 
         const text = self.source[self.start..self.current];
-        const token_type = getKeywordType(text) orelse .identifier;
-        try self.addToken(token_type);
+        if (getKeywordType(text)) |keyword| return keyword;
+
+        // Intern here, while the spelling is already in cache; every later
+        // phase sees this identifier as a dense u32 symbol.
+        self.last_symbol = try self.interner.intern(text);
+        return .identifier;
     }
 
-    fn addToken(self: *Self, token_type: TokenType) !void {
-        const text = self.source[self.start..self.current];
-        try self.addTokenWithLexeme(token_type, text);
+    // Vectorized scanning kernels. Hot inputs are dominated by long
+    // identifiers and comment banners, where byte-at-a-time advancing is
+    // branch-latency bound; classifying vector_len bytes per iteration lets
+    // tokenize throughput scale with memory bandwidth instead. Each kernel
+    // returns the index of the first byte past the run, with a scalar tail
+    // for the final partial chunk.
+    const vector_len = 16;
+    const Chunk = @Vector(vector_len, u8);
+    const ChunkMask = std.meta.Int(.unsigned, vector_len);
+
+    fn splat(byte: u8) Chunk {
+        return @splat(byte);
     }
 
-    fn addTokenWithLexeme(self: *Self, token_type: TokenType, lexeme: []const u8) !void {
-        try self.tokens.append(self.allocator, Token{
-            .type = token_type,
-            .lexeme = lexeme,
-            .line = self.line,
-            .column = self.column - @as(u32, @intCast(lexeme.len)),
-        });
+    fn inRange(chunk: Chunk, lo: u8, hi: u8) ChunkMask {
+        const ge: ChunkMask = @bitCast(chunk >= splat(lo));
+        const le: ChunkMask = @bitCast(chunk <= splat(hi));
+        return ge & le;
+    }
+
+    fn alnumRunEnd(source: []const u8, start: usize) usize {
+        var i = start;
+        while (i + vector_len <= source.len) {
+            const chunk: Chunk = source[i..][0..vector_len].*;
+            const underscore: ChunkMask = @bitCast(chunk == splat('_'));
+            const alnum = inRange(chunk, 'a', 'z') | inRange(chunk, 'A', 'Z') |
+                inRange(chunk, '0', '9') | underscore;
+            const stop = ~alnum;
+            if (stop != 0) return i + @ctz(stop);
+            i += vector_len;
+        }
+        while (i < source.len and isAlphaNumeric(source[i])) {
+            i += 1;
+        }
+        return i;
+    }
+
+    fn digitRunEnd(source: []const u8, start: usize) usize {
+        var i = start;
+        while (i + vector_len <= source.len) {
+            const chunk: Chunk = source[i..][0..vector_len].*;
+            const stop = ~inRange(chunk, '0', '9');
+            if (stop != 0) return i + @ctz(stop);
+            i += vector_len;
+        }
+        while (i < source.len and isDigit(source[i])) {
+            i += 1;
+        }
+        return i;
+    }
+
+    // Run of ' ', '\r', '\t'. Deliberately excludes '\n', which scanToken
+    // handles separately to maintain the line table.
+    fn whitespaceRunEnd(source: []const u8, start: usize) usize {
+        var i = start;
+        while (i + vector_len <= source.len) {
+            const chunk: Chunk = source[i..][0..vector_len].*;
+            const space: ChunkMask = @bitCast(chunk == splat(' '));
+            const cr: ChunkMask = @bitCast(chunk == splat('\r'));
+            const tab: ChunkMask = @bitCast(chunk == splat('\t'));
+            const stop = ~(space | cr | tab);
+            if (stop != 0) return i + @ctz(stop);
+            i += vector_len;
+        }
+        while (i < source.len and (source[i] == ' ' or source[i] == '\r' or source[i] == '\t')) {
+            i += 1;
+        }
+        return i;
+    }
+
+    // Index of the next '\n' (left unconsumed), or end of source.
+    fn lineEnd(source: []const u8, start: usize) usize {
+        var i = start;
+        while (i + vector_len <= source.len) {
+            const chunk: Chunk = source[i..][0..vector_len].*;
+            const newline: ChunkMask = @bitCast(chunk == splat('\n'));
+            if (newline != 0) return i + @ctz(newline);
+            i += vector_len;
+        }
+        while (i < source.len and source[i] != '\n') {
+            i += 1;
+        }
+        return i;
     }
 
     fn isDigit(c: u8) bool {
@@ -346,30 +613,98 @@ pub const Lexer = struct {
         return isAlpha(c) or isDigit(c);
     }
 
+    // Keyword recognition via a comptime-generated perfect hash. The old
+    // implementation did up to fifteen sequential std.mem.eql calls per
+    // identifier, so the common case -- a plain identifier -- paid the full
+    // miss chain. Here a seed is searched at compile time so that every
+    // keyword lands in its own slot of a small table keyed off the first
+    // byte, last byte, and length; classification is one hash, a length
+    // check, and at most one memcmp.
+    const keyword_list = [_]struct { []const u8, TokenType }{
+        .{ "fn", .fn_ },
+        .{ "const", .const_ },
+        .{ "let", .let_ },
+        .{ "return", .return_ },
+        .{ "if", .if_ },
+        .{ "else", .else_ },
+        .{ "while", .while_ },
+        .{ "for", .for_ },
+        .{ "in", .in_ },
+        .{ "true", .true_ },
+        .{ "false", .false_ },
+        .{ "i32", .i32 },
+        .{ "f64", .f64 },
+        .{ "bool", .bool },
+        .{ "void", .void },
+        .{ "string", .string },
+    };
+
+    const keyword_table_size = 32;
+
+    const min_keyword_len = blk: {
+        var lo: usize = std.math.maxInt(usize);
+        for (keyword_list) |kw| lo = @min(lo, kw[0].len);
+        break :blk lo;
+    };
+
+    const max_keyword_len = blk: {
+        var hi: usize = 0;
+        for (keyword_list) |kw| hi = @max(hi, kw[0].len);
+        break :blk hi;
+    };
+
+    fn keywordHash(seed: u32, text: []const u8) u32 {
+        const first: u32 = text[0];
+        const last: u32 = text[text.len - 1];
+        return (first *% seed +% last *% 0x9e3779b9 +% @as(u32, @intCast(text.len))) % keyword_table_size;
+    }
+
+    const keyword_seed: u32 = blk: {
+        @setEvalBranchQuota(100_000);
+        var seed: u32 = 1;
+        while (seed < 10_000) : (seed += 1) {
+            var used = [_]bool{false} ** keyword_table_size;
+            var collided = false;
+            for (keyword_list) |kw| {
+                const slot = keywordHash(seed, kw[0]);
+                if (used[slot]) {
+                    collided = true;
+                    break;
+                }
+                used[slot] = true;
+            }
+            if (!collided) break :blk seed;
+        }
+        @compileError("no perfect hash seed found for keyword table");
+    };
+
+    const KeywordSlot = struct {
+        text: []const u8,
+        token: TokenType,
+    };
+
+    const keyword_table: [keyword_table_size]?KeywordSlot = blk: {
+        var table = [_]?KeywordSlot{null} ** keyword_table_size;
+        for (keyword_list) |kw| {
+            table[keywordHash(keyword_seed, kw[0])] = .{ .text = kw[0], .token = kw[1] };
+        }
+        break :blk table;
+    };
+
     fn getKeywordType(text: []const u8) ?TokenType {
-        if (std.mem.eql(u8, text, "fn")) return .fn_;
-        if (std.mem.eql(u8, text, "const")) return .const_;
-        if (std.mem.eql(u8, text, "let")) return .let_;
-        if (std.mem.eql(u8, text, "return")) return .return_;
-        if (std.mem.eql(u8, text, "if")) return .if_;
-        if (std.mem.eql(u8, text, "else")) return .else_;
-        if (std.mem.eql(u8, text, "while")) return .while_;
-        if (std.mem.eql(u8, text, "for")) return .for_;
-        if (std.mem.eql(u8, text, "true")) return .true_;
-        if (std.mem.eql(u8, text, "false")) return .false_;
-        if (std.mem.eql(u8, text, "i32")) return .i32;
-        if (std.mem.eql(u8, text, "f64")) return .f64;
-        if (std.mem.eql(u8, text, "bool")) return .bool;
-        if (std.mem.eql(u8, text, "void")) return .void;
-        if (std.mem.eql(u8, text, "string")) return .string;
-        return null;
+        if (text.len < min_keyword_len or text.len > max_keyword_len) return null;
+        const slot = keyword_table[keywordHash(keyword_seed, text)] orelse return null;
+        if (slot.text.len != text.len) return null;
+        if (!std.mem.eql(u8, slot.text, text)) return null;
+        return slot.token;
     }
 };
 
 // Helper function for debugging
-pub fn printTokens(tokens: []Token) void {
+pub fn printTokens(tokens: *const TokenBuffer) void {
     std.debug.print("Tokens:\n");
-    for (tokens) |token| {
+    for (0..tokens.len()) |i| {
+        const token = tokens.get(i);
         std.debug.print("  {s}: '{s}' at {}:{}\n", .{ token.type.toString(), token.lexeme, token.line, token.column });
     }
 }
\ No newline at end of file
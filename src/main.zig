@@ -4,7 +4,15 @@ const parser = @import("parser.zig");
 const ast = @import("ast.zig");
 const types = @import("types.zig");
 const checker = @import("checker.zig");
+const fold = @import("fold.zig");
 const codegen = @import("codegen.zig");
+const intern = @import("intern.zig");
+const cache = @import("cache.zig");
+const astcache = @import("astcache.zig");
+const llvm = @import("llvm");
+
+// Buffered print runtime linked into every `zenc build` executable.
+const runtime_source = @embedFile("zen_runtime.c");
 
 const CompilerError = error{
     InvalidArguments,
@@ -21,64 +29,615 @@ pub fn main() !void {
     const args = try std.process.argsAlloc(allocator);
     defer std.process.argsFree(allocator, args);
 
-    if (args.len < 2) {
-        std.debug.print("Usage: zenc <source_file.zen>\n", .{});
+    // `zenc build` goes source-to-executable in one invocation: objects
+    // are emitted in-process and a single link step produces the binary.
+    var build_mode = false;
+    var flag_args: []const []const u8 = args[1..];
+    if (flag_args.len > 0 and std.mem.eql(u8, flag_args[0], "build")) {
+        build_mode = true;
+        flag_args = flag_args[1..];
+    }
+
+    var options = CompileOptions{};
+    var watch_mode = false;
+    var output_path: ?[]const u8 = null;
+    var source_files = std.ArrayList([]const u8){};
+    defer source_files.deinit(allocator);
+
+    var arg_index: usize = 0;
+    while (arg_index < flag_args.len) : (arg_index += 1) {
+        const arg = flag_args[arg_index];
+        if (std.mem.eql(u8, arg, "--check")) {
+            options.check_only = true;
+        } else if (std.mem.eql(u8, arg, "--emit=ll")) {
+            options.emit = .ll;
+        } else if (std.mem.eql(u8, arg, "--emit=obj")) {
+            options.emit = .obj;
+        } else if (std.mem.eql(u8, arg, "-O0")) {
+            options.opt = .O0;
+        } else if (std.mem.eql(u8, arg, "-O1")) {
+            options.opt = .O1;
+        } else if (std.mem.eql(u8, arg, "-O2")) {
+            options.opt = .O2;
+        } else if (std.mem.eql(u8, arg, "-O3")) {
+            options.opt = .O3;
+        } else if (std.mem.eql(u8, arg, "--cache")) {
+            options.use_cache = true;
+        } else if (std.mem.eql(u8, arg, "--watch")) {
+            watch_mode = true;
+        } else if (std.mem.eql(u8, arg, "--time-report")) {
+            options.report = .text;
+        } else if (std.mem.eql(u8, arg, "--time-report=json")) {
+            options.report = .json;
+        } else if (std.mem.eql(u8, arg, "--mem-stats")) {
+            options.mem_stats = true;
+        } else if (std.mem.eql(u8, arg, "-o")) {
+            arg_index += 1;
+            if (arg_index >= flag_args.len) {
+                std.debug.print("-o expects an output path\n", .{});
+                return CompilerError.InvalidArguments;
+            }
+            output_path = flag_args[arg_index];
+        } else if (std.mem.startsWith(u8, arg, "-")) {
+            std.debug.print("Unknown option: {s}\n", .{arg});
+            return CompilerError.InvalidArguments;
+        } else {
+            try source_files.append(allocator, arg);
+        }
+    }
+
+    if (source_files.items.len == 0) {
+        std.debug.print("Usage: zenc [build] [--check] [--watch] [--time-report[=json]] [--mem-stats] [--emit=ll|obj] [-O0|-O1|-O2|-O3] [-o output] <source_file.zen> [more_files.zen ...]\n", .{});
         std.debug.print("Zen Programming Language Compiler - Phase 1\n", .{});
         return CompilerError.InvalidArguments;
     }
 
-    const source_file = args[1];
-    std.debug.print("Compiling: {s}\n", .{source_file});
+    if (build_mode) {
+        // Linking needs native objects regardless of the requested emit.
+        options.emit = .obj;
+    }
+
+    if (watch_mode) {
+        return watchLoop(allocator, source_files.items, options, output_path, build_mode);
+    }
+
+    if (source_files.items.len == 1) {
+        try compileFile(allocator, source_files.items[0], options);
+    } else {
+        try compileBatch(allocator, source_files.items, options);
+    }
+
+    if (build_mode) {
+        try linkExecutable(allocator, source_files.items, output_path);
+    }
+}
+
+// How often watch mode polls source mtimes. std has no portable file
+// watcher, so this is a stat loop; at this interval the stats are
+// invisible next to a compile.
+const watch_poll_interval_ns = 200 * std.time.ns_per_ms;
+
+// Watch mode: one long-lived process recompiles sources as they change,
+// so the per-invocation fixed costs -- process startup, allocator setup,
+// LLVMContextCreate -- are paid once instead of per edit. The LLVM
+// context is created here and threaded through every recompile; builtin
+// declarations are per-module and still rebuilt, but module setup is
+// cheap next to context creation. Changed files recompile serially, so
+// the shared context is never used from two threads. Pairs well with
+// --cache, which keeps unchanged functions' artifacts warm on disk.
+fn watchLoop(allocator: std.mem.Allocator, source_files: []const []const u8, options: CompileOptions, output_path: ?[]const u8, build_mode: bool) !void {
+    var warm_options = options;
+    const warm_context: ?llvm.LLVMContextRef = if (options.check_only) null else llvm.LLVMContextCreate();
+    defer if (warm_context) |context| llvm.LLVMContextDispose(context);
+    warm_options.llvm_context = warm_context;
+
+    const mtimes = try allocator.alloc(i128, source_files.len);
+    defer allocator.free(mtimes);
+    @memset(mtimes, 0);
+
+    std.debug.print("Watching {} file(s), press Ctrl-C to stop\n", .{source_files.len});
+    while (true) {
+        var recompiled = false;
+        var failed = false;
+        for (source_files, mtimes) |path, *mtime| {
+            const stat = std.fs.cwd().statFile(path) catch continue;
+            if (stat.mtime == mtime.*) continue;
+            mtime.* = stat.mtime;
+
+            recompiled = true;
+            compileFile(allocator, path, warm_options) catch {
+                // Keep watching; the next edit gets a fresh compile.
+                failed = true;
+            };
+        }
+
+        if (recompiled and build_mode and !failed) {
+            linkExecutable(allocator, source_files, output_path) catch {};
+        }
+        if (recompiled) {
+            std.debug.print("Watching for changes...\n", .{});
+        }
+
+        std.Thread.sleep(watch_poll_interval_ns);
+    }
+}
+
+// Link the objects produced above into an executable with one cc
+// invocation. The llvm-c bindings don't expose lld, so this is the
+// remaining out-of-process step — but it's a single spawn straight from
+// native objects, replacing the old zenc -> clang -> ld dance and its
+// textual-IR round trip.
+fn linkExecutable(allocator: std.mem.Allocator, source_files: []const []const u8, output_path: ?[]const u8) !void {
+    var object_files = std.ArrayList([]const u8){};
+    defer {
+        for (object_files.items) |object_file| allocator.free(object_file);
+        object_files.deinit(allocator);
+    }
+    for (source_files) |path| {
+        const object_file = try std.fmt.allocPrint(allocator, "{s}.o", .{path[0 .. path.len - 4]});
+        try object_files.append(allocator, object_file);
+    }
+
+    const first = source_files[0];
+    const output = output_path orelse first[0 .. first.len - 4];
+
+    // The runtime source travels embedded in the compiler binary and is
+    // materialized into the cache directory for cc to compile alongside
+    // the objects, so generated code resolves the zen_print builtins
+    // without any installed runtime.
+    const runtime_path = cache.cache_dir_name ++ "/zen_runtime.c";
+    std.fs.cwd().makePath(cache.cache_dir_name) catch {};
+    std.fs.cwd().writeFile(.{ .sub_path = runtime_path, .data = runtime_source }) catch |err| {
+        std.debug.print("Failed to write runtime source: {}\n", .{err});
+        return CompilerError.CompilationFailed;
+    };
+
+    var argv = std.ArrayList([]const u8){};
+    defer argv.deinit(allocator);
+    try argv.append(allocator, "cc");
+    try argv.appendSlice(allocator, object_files.items);
+    try argv.appendSlice(allocator, &.{ runtime_path, "-o", output });
+
+    var child = std.process.Child.init(argv.items, allocator);
+    const term = child.spawnAndWait() catch |err| {
+        std.debug.print("Failed to run linker: {}\n", .{err});
+        return CompilerError.CompilationFailed;
+    };
+    switch (term) {
+        .Exited => |code| if (code != 0) {
+            std.debug.print("Linker exited with code {}\n", .{code});
+            return CompilerError.CompilationFailed;
+        },
+        else => return CompilerError.CompilationFailed,
+    }
+}
+
+const CompileOptions = struct {
+    // Diagnostics-only mode for editor integration: run the front-end
+    // phases and stop before code generation, so no LLVM context is ever
+    // created on the red-squiggle path.
+    check_only: bool = false,
+    // What generateProgram writes: textual IR for debugging, or a native
+    // object straight from the in-memory module.
+    emit: codegen.EmitKind = .ll,
+    // In-process LLVM optimization pipeline run before emission.
+    opt: codegen.OptLevel = .O0,
+    // Incremental compilation: cache per-function artifacts in .zen-cache
+    // and skip checking/codegen for functions whose content is unchanged.
+    use_cache: bool = false,
+    // Set by watch mode: reuse one LLVM context across recompiles instead
+    // of creating and disposing one per invocation.
+    llvm_context: ?llvm.LLVMContextRef = null,
+    // Phase timing and counter report, for tracking compile-time
+    // regressions in CI. Off by default; compiles print nothing.
+    report: ReportFormat = .none,
+    // Route phase allocations through a counting layer and report
+    // per-phase allocator statistics alongside the time report.
+    mem_stats: bool = false,
+};
+
+const ReportFormat = enum { none, text, json };
+
+// Wall time and size counters for one compile, written as a single
+// buffered report at the end so instrumentation never interleaves
+// unbuffered writes into the measured region. In the streaming pipeline
+// the lexer runs inside the parse phase, so lex_ns stays zero and
+// parse_ns covers both; the same holds when the tree is loaded from the
+// .zast cache.
+const TimeReport = struct {
+    lex_ns: u64 = 0,
+    parse_ns: u64 = 0,
+    check_ns: u64 = 0,
+    codegen_ns: u64 = 0,
+    tokens: u64 = 0,
+    ast_nodes: u64 = 0,
+    llvm_instructions: u64 = 0,
+
+    fn emit(self: *const TimeReport, allocator: std.mem.Allocator, filename: []const u8, format: ReportFormat) void {
+        const total_ns = self.lex_ns + self.parse_ns + self.check_ns + self.codegen_ns;
+        const peak_rss_kib = peakRssKib();
+
+        const text = switch (format) {
+            .none => return,
+            .text => std.fmt.allocPrint(allocator,
+                \\zenc time report: {s}
+                \\  lex      {d:>12} ns  ({d} tokens)
+                \\  parse    {d:>12} ns  ({d} ast nodes)
+                \\  check    {d:>12} ns
+                \\  codegen  {d:>12} ns  ({d} llvm instructions)
+                \\  total    {d:>12} ns  (peak rss {d} KiB)
+                \\
+            , .{ filename, self.lex_ns, self.tokens, self.parse_ns, self.ast_nodes, self.check_ns, self.codegen_ns, self.llvm_instructions, total_ns, peak_rss_kib }),
+            .json => std.fmt.allocPrint(allocator,
+                \\{{"file":"{s}","lex_ns":{d},"parse_ns":{d},"check_ns":{d},"codegen_ns":{d},"total_ns":{d},"tokens":{d},"ast_nodes":{d},"llvm_instructions":{d},"peak_rss_kib":{d}}}
+                \\
+            , .{ filename, self.lex_ns, self.parse_ns, self.check_ns, self.codegen_ns, total_ns, self.tokens, self.ast_nodes, self.llvm_instructions, peak_rss_kib }),
+        } catch return;
+        defer allocator.free(text);
+
+        std.fs.File.stderr().writeAll(text) catch {};
+    }
+
+    fn peakRssKib() u64 {
+        const usage = std.posix.getrusage(std.posix.rusage.SELF);
+        return @intCast(@max(usage.maxrss, 0));
+    }
+};
+
+const Phase = enum { lex, parse, check, codegen };
+
+// Allocator statistics for one phase: how many allocations it made, how
+// many bytes it asked for in total, the live-byte high-water mark while
+// the phase ran, and the largest single request.
+const MemStats = struct {
+    allocations: u64 = 0,
+    bytes: u64 = 0,
+    peak_live: u64 = 0,
+    largest: u64 = 0,
+};
+
+// Counting layer between the phases and the real allocator, enabled by
+// --mem-stats. The driver moves `phase` forward as the pipeline advances
+// and every request is charged to the current phase, so arena and
+// interning changes can be validated with numbers instead of guesses.
+// A mutex covers the counters because the checker and codegen fan work
+// out across a thread pool; allocations made by workers are charged to
+// the phase that spawned them.
+const CountingAllocator = struct {
+    backing: std.mem.Allocator,
+    mutex: std.Thread.Mutex = .{},
+    phase: Phase = .lex,
+    live: u64 = 0,
+    stats: [4]MemStats = .{ .{}, .{}, .{}, .{} },
+
+    fn init(backing: std.mem.Allocator) CountingAllocator {
+        return .{ .backing = backing };
+    }
+
+    fn allocator(self: *CountingAllocator) std.mem.Allocator {
+        return .{ .ptr = self, .vtable = &vtable };
+    }
+
+    fn setPhase(self: *CountingAllocator, phase: Phase) void {
+        self.mutex.lock();
+        defer self.mutex.unlock();
+        self.phase = phase;
+    }
+
+    const vtable = std.mem.Allocator.VTable{
+        .alloc = alloc,
+        .resize = resize,
+        .remap = remap,
+        .free = free,
+    };
+
+    fn current(self: *CountingAllocator) *MemStats {
+        return &self.stats[@intFromEnum(self.phase)];
+    }
+
+    // Caller holds the mutex. `grown` is the net new bytes (zero for
+    // shrinks), which also feeds the live high-water mark.
+    fn charge(self: *CountingAllocator, grown: u64, is_new_allocation: bool) void {
+        const stats = self.current();
+        if (is_new_allocation) {
+            stats.allocations += 1;
+            stats.largest = @max(stats.largest, grown);
+        }
+        stats.bytes += grown;
+        self.live += grown;
+        stats.peak_live = @max(stats.peak_live, self.live);
+    }
+
+    fn alloc(ctx: *anyopaque, len: usize, alignment: std.mem.Alignment, ret_addr: usize) ?[*]u8 {
+        const self: *CountingAllocator = @ptrCast(@alignCast(ctx));
+        const result = self.backing.rawAlloc(len, alignment, ret_addr) orelse return null;
+        self.mutex.lock();
+        defer self.mutex.unlock();
+        self.charge(len, true);
+        return result;
+    }
+
+    fn resize(ctx: *anyopaque, memory: []u8, alignment: std.mem.Alignment, new_len: usize, ret_addr: usize) bool {
+        const self: *CountingAllocator = @ptrCast(@alignCast(ctx));
+        if (!self.backing.rawResize(memory, alignment, new_len, ret_addr)) return false;
+        self.recountResized(memory.len, new_len);
+        return true;
+    }
+
+    fn remap(ctx: *anyopaque, memory: []u8, alignment: std.mem.Alignment, new_len: usize, ret_addr: usize) ?[*]u8 {
+        const self: *CountingAllocator = @ptrCast(@alignCast(ctx));
+        const result = self.backing.rawRemap(memory, alignment, new_len, ret_addr) orelse return null;
+        self.recountResized(memory.len, new_len);
+        return result;
+    }
+
+    fn recountResized(self: *CountingAllocator, old_len: usize, new_len: usize) void {
+        self.mutex.lock();
+        defer self.mutex.unlock();
+        if (new_len > old_len) {
+            self.charge(new_len - old_len, false);
+        } else {
+            self.live -= @min(self.live, old_len - new_len);
+        }
+    }
+
+    fn free(ctx: *anyopaque, memory: []u8, alignment: std.mem.Alignment, ret_addr: usize) void {
+        const self: *CountingAllocator = @ptrCast(@alignCast(ctx));
+        self.backing.rawFree(memory, alignment, ret_addr);
+        self.mutex.lock();
+        defer self.mutex.unlock();
+        self.live -= @min(self.live, memory.len);
+    }
+
+    // One buffered block, matching the time report's shape. Reports go to
+    // the backing allocator so the report itself is never counted.
+    fn emit(self: *CountingAllocator, filename: []const u8, format: ReportFormat) void {
+        var text = std.ArrayList(u8){};
+        defer text.deinit(self.backing);
+
+        switch (format) {
+            .json => {
+                appendReport(&text, self.backing, "{{\"file\":\"{s}\",\"mem\":[", .{filename});
+                for (self.stats, 0..) |stats, i| {
+                    appendReport(&text, self.backing, "{s}{{\"phase\":\"{s}\",\"allocations\":{d},\"bytes\":{d},\"peak_live\":{d},\"largest\":{d}}}", .{
+                        if (i == 0) "" else ",", @tagName(@as(Phase, @enumFromInt(i))), stats.allocations, stats.bytes, stats.peak_live, stats.largest,
+                    });
+                }
+                appendReport(&text, self.backing, "]}}\n", .{});
+            },
+            // --mem-stats without --time-report=json still reports, as text.
+            .none, .text => {
+                appendReport(&text, self.backing, "zenc memory report: {s}\n", .{filename});
+                for (self.stats, 0..) |stats, i| {
+                    appendReport(&text, self.backing, "  {s:<8} {d:>8} allocs  {d:>12} bytes  peak live {d:>12}  largest {d:>10}\n", .{
+                        @tagName(@as(Phase, @enumFromInt(i))), stats.allocations, stats.bytes, stats.peak_live, stats.largest,
+                    });
+                }
+            },
+        }
+
+        std.fs.File.stderr().writeAll(text.items) catch {};
+    }
+
+    fn appendReport(text: *std.ArrayList(u8), backing: std.mem.Allocator, comptime fmt: []const u8, args: anytype) void {
+        const line = std.fmt.allocPrint(backing, fmt, args) catch return;
+        defer backing.free(line);
+        text.appendSlice(backing, line) catch {};
+    }
+};
+
+// Batch mode: each file is an independent compile in the current language,
+// so the files fan out across a pool with one worker per core. Every job
+// builds its own interner, arena, checker, and LLVM context, so the
+// workers share nothing but the (thread-safe) backing allocator.
+fn compileBatch(allocator: std.mem.Allocator, source_files: []const []const u8, options: CompileOptions) !void {
+    var pool: std.Thread.Pool = undefined;
+    try pool.init(.{
+        .allocator = allocator,
+        .n_jobs = @min(std.Thread.getCpuCount() catch 1, source_files.len),
+    });
+    defer pool.deinit();
+
+    var failures = std.atomic.Value(u32).init(0);
+    var wait_group: std.Thread.WaitGroup = .{};
+    for (source_files) |path| {
+        pool.spawnWg(&wait_group, compileJob, .{ allocator, path, options, &failures });
+    }
+    pool.waitAndWork(&wait_group);
 
+    const failed = failures.load(.monotonic);
+    if (failed > 0) {
+        std.debug.print("{} of {} files failed to compile\n", .{ failed, source_files.len });
+        return CompilerError.CompilationFailed;
+    }
+}
+
+fn compileJob(allocator: std.mem.Allocator, path: []const u8, options: CompileOptions, failures: *std.atomic.Value(u32)) void {
+    compileFile(allocator, path, options) catch {
+        _ = failures.fetchAdd(1, .monotonic);
+    };
+}
+
+fn compileFile(allocator: std.mem.Allocator, path: []const u8, options: CompileOptions) !void {
     // Read source file
-    const file_contents = std.fs.cwd().readFileAlloc(allocator, source_file, std.math.maxInt(usize)) catch |err| {
-        std.debug.print("Error reading file '{s}': {}\n", .{ source_file, err });
+    var source = SourceFile.open(allocator, path) catch |err| {
+        std.debug.print("Error reading file '{s}': {}\n", .{ path, err });
         return CompilerError.FileNotFound;
     };
-    defer allocator.free(file_contents);
+    defer source.deinit(allocator);
 
     // Compilation pipeline
-    try compileZenSource(allocator, file_contents, source_file);
+    try compileZenSource(allocator, source.contents, path, options);
 }
 
-fn compileZenSource(allocator: std.mem.Allocator, source: []const u8, filename: []const u8) !void {
-    std.debug.print("Phase 1: Lexical Analysis\n", .{});
+// Source input for one compile. Large generated inputs are mapped instead of
+// read: the Lexer gets a zero-copy view of the file and page-in overlaps
+// tokenization, instead of paying a full-file allocation and copy before
+// Phase 1 starts. Falls back to a heap read where mmap is unavailable
+// (pipes, some filesystems) or the file is empty.
+const SourceFile = struct {
+    contents: []const u8,
+    mapping: ?[]align(std.heap.page_size_min) u8,
+
+    pub fn open(allocator: std.mem.Allocator, path: []const u8) !SourceFile {
+        const file = try std.fs.cwd().openFile(path, .{});
+        defer file.close();
+
+        const size = try file.getEndPos();
+        if (size > 0) {
+            if (std.posix.mmap(
+                null,
+                size,
+                std.posix.PROT.READ,
+                .{ .TYPE = .PRIVATE },
+                file.handle,
+                0,
+            )) |mapping| {
+                return SourceFile{ .contents = mapping[0..size], .mapping = mapping };
+            } else |_| {
+                // Fall through to the buffered read below.
+            }
+        }
+
+        const contents = try file.readToEndAlloc(allocator, std.math.maxInt(usize));
+        return SourceFile{ .contents = contents, .mapping = null };
+    }
+
+    pub fn deinit(self: *SourceFile, allocator: std.mem.Allocator) void {
+        if (self.mapping) |mapping| {
+            std.posix.munmap(mapping);
+        } else {
+            allocator.free(@constCast(self.contents));
+        }
+    }
+};
+
+// Above this size the lexer and parser run as a streaming pipeline: the
+// parser pulls tokens on demand instead of waiting for a fully materialized
+// token buffer, so peak memory excludes the token array and the two phases
+// overlap. Small files keep the batch path, whose buffer the later
+// phases can also reuse.
+const streaming_threshold = 16 * 1024 * 1024;
+
+fn compileZenSource(allocator: std.mem.Allocator, source: []const u8, filename: []const u8, options: CompileOptions) !void {
+    var report = TimeReport{};
+    var timer: ?std.time.Timer = std.time.Timer.start() catch null;
+
+    // With --mem-stats every phase allocates through the counting layer;
+    // driver-side bookkeeping (paths, reports) stays on the backing
+    // allocator so it never pollutes the phase numbers.
+    var counting: ?CountingAllocator = null;
+    if (options.mem_stats) counting = CountingAllocator.init(allocator);
+    const phase_allocator = if (counting) |*c| c.allocator() else allocator;
+
+    // One interner per compile: every identifier is hashed once here and
+    // travels through the later phases as a u32 symbol.
+    var interner = intern.StringInterner.init(phase_allocator);
+    defer interner.deinit();
 
     // Tokenize
-    var tokenizer = lexer.Lexer.init(allocator, source);
+    var tokenizer = lexer.Lexer.init(phase_allocator, source, &interner);
     defer tokenizer.deinit();
 
-    const tokens = try tokenizer.tokenize();
-    defer allocator.free(tokens);
-    std.debug.print("Generated {} tokens\n", .{tokens.len});
+    // The whole syntax tree for one compile comes out of a single arena and is
+    // released in one free, instead of node-by-node through the GPA.
+    var ast_arena = ast.AstArena.init(phase_allocator);
+    defer ast_arena.deinit();
+
+    // Binary AST cache: when enabled and the .zast next to the source still
+    // matches its content hash, the whole tree is mapped in and Phases 1-2
+    // are skipped. The mapping backs the tree's storage, so it stays alive
+    // until the compile finishes.
+    var loaded_tree: ?astcache.LoadedAst = null;
+    defer if (loaded_tree) |*loaded| loaded.deinit();
+    var zast_path: ?[]u8 = null;
+    defer if (zast_path) |path| allocator.free(path);
+    if (options.use_cache) {
+        zast_path = try std.fmt.allocPrint(allocator, "{s}.zast", .{filename[0 .. filename.len - 4]});
+    }
+
+    var syntax_tree: ast.Ast = undefined;
+    if (zast_path) |path| {
+        if (astcache.load(path, source, &interner)) |loaded| {
+            loaded_tree = loaded;
+            syntax_tree = loaded.tree;
+        }
+    }
 
-    std.debug.print("Phase 2: Syntax Analysis\n", .{});
+    if (loaded_tree == null) {
+        if (source.len >= streaming_threshold) {
+            // Streaming: the lexer runs inside the parse, so the whole
+            // front end lands in parse_ns.
+            if (counting) |*c| c.setPhase(.parse);
+            var stream = lexer.TokenStream.init(&tokenizer);
+            var zen_parser = parser.Parser.initStreaming(ast_arena.allocator(), &stream);
+            defer zen_parser.deinit();
 
-    // Parse
-    var zen_parser = parser.Parser.init(allocator, tokens);
-    defer zen_parser.deinit();
+            syntax_tree = try zen_parser.parseProgram();
+        } else {
+            var tokens = try tokenizer.tokenize();
+            defer tokens.deinit(phase_allocator);
+            report.tokens = tokens.len();
+            if (timer) |*t| report.lex_ns = t.lap();
 
-    const syntax_tree = try zen_parser.parseProgram();
-    defer ast.destroyNode(allocator, syntax_tree);
-    std.debug.print("Built AST with {} nodes\n", .{syntax_tree.data.program.statements.len});
+            if (counting) |*c| c.setPhase(.parse);
+            var zen_parser = parser.Parser.init(ast_arena.allocator(), tokens);
+            defer zen_parser.deinit();
 
-    std.debug.print("Phase 3: Type Checking\n", .{});
+            syntax_tree = try zen_parser.parseProgram();
+        }
+
+        // Write the tree back out now, before the checker and codegen
+        // intern their builtin names: the saved name table must contain
+        // only source-backed spellings.
+        if (zast_path) |path| {
+            astcache.save(allocator, path, &syntax_tree, &interner, source) catch {};
+        }
+    }
+    report.ast_nodes = syntax_tree.nodeCount();
+    if (timer) |*t| report.parse_ns = t.lap();
+
+    // Per-function incremental cache, consulted by both the checker and
+    // the code generator. Failure to open it just means a full compile.
+    var function_cache: ?cache.FunctionCache = null;
+    defer if (function_cache) |*fc| fc.deinit();
+    if (options.use_cache) {
+        function_cache = cache.FunctionCache.open() catch null;
+    }
 
     // Type check
-    var type_checker = checker.TypeChecker.init(allocator);
+    if (counting) |*c| c.setPhase(.check);
+    var type_checker = checker.TypeChecker.init(phase_allocator, &interner);
     defer type_checker.deinit();
+    type_checker.source = source;
+    if (function_cache) |*fc| type_checker.function_cache = fc;
+
+    try type_checker.checkProgram(&syntax_tree);
+    if (timer) |*t| report.check_ns = t.lap();
 
-    try type_checker.checkProgram(syntax_tree);
-    std.debug.print("Type checking passed\n", .{});
+    if (options.check_only) {
+        report.emit(allocator, filename, options.report);
+        if (counting) |*c| c.emit(filename, options.report);
+        return;
+    }
 
-    std.debug.print("Phase 4: Code Generation\n", .{});
+    // Evaluate literal arithmetic and propagate folded consts before
+    // codegen walks the tree.
+    try fold.foldProgram(phase_allocator, &syntax_tree);
 
     // Generate LLVM IR
-    var code_generator = codegen.CodeGenerator.init(allocator);
+    if (counting) |*c| c.setPhase(.codegen);
+    var code_generator = if (options.llvm_context) |context|
+        codegen.CodeGenerator.initInContext(phase_allocator, &interner, context)
+    else
+        codegen.CodeGenerator.init(phase_allocator, &interner);
     defer code_generator.deinit();
+    if (function_cache) |*fc| code_generator.function_cache = fc;
 
-    try code_generator.generateProgram(syntax_tree, filename);
-    std.debug.print("Code generation complete\n", .{});
+    try code_generator.generateProgram(&syntax_tree, filename, options.emit, options.opt);
+    report.llvm_instructions = code_generator.instructionCount();
+    if (timer) |*t| report.codegen_ns = t.lap();
 
-    std.debug.print("Compilation successful!\n", .{});
+    report.emit(allocator, filename, options.report);
+    if (counting) |*c| c.emit(filename, options.report);
 }
@@ -2,8 +2,9 @@ const std = @import("std");
 const lexer = @import("lexer.zig");
 const ast = @import("ast.zig");
 const types = @import("types.zig");
+const diagnostics = @import("diagnostics.zig");
 
-const Token = lexer.Token;
+const TokenBuffer = lexer.TokenBuffer;
 const TokenType = lexer.TokenType;
 
 pub const ParseError = error{
@@ -15,48 +16,118 @@ pub const ParseError = error{
     OutOfMemory,
 };
 
+// Where the parser's tokens come from: either a fully materialized
+// TokenBuffer, or a TokenStream that pulls tokens from the Lexer on demand.
+// Streaming avoids materializing the token array for large files and
+// overlaps lexing with parsing; lexer errors surface as .error_ tokens,
+// which the grammar rejects like any other unexpected token.
+const TokenSource = union(enum) {
+    buffer: struct {
+        tokens: TokenBuffer,
+        current: usize,
+    },
+    stream: *lexer.TokenStream,
+};
+
 pub const Parser = struct {
     const Self = @This();
 
     allocator: std.mem.Allocator,
-    tokens: []Token,
-    current: usize,
+    source: TokenSource,
+    // The most recently consumed token; what previous() used to index.
+    prev: lexer.StreamedToken,
+    // The flat tree under construction; moved out by parseProgram.
+    tree: ast.Ast,
+    // Errors found so far. Parsing recovers at statement boundaries and
+    // keeps going, so one run reports them all; parseProgram flushes the
+    // sorted batch and fails if any were recorded.
+    errors: diagnostics.DiagnosticList,
+
+    // `allocator` owns every node the parser creates. Pass an
+    // ast.AstArena allocator so the whole tree is released in one free;
+    // with a general-purpose allocator the caller must call Ast.deinit
+    // instead.
+    pub fn init(allocator: std.mem.Allocator, tokens: TokenBuffer) Self {
+        return Self{
+            .allocator = allocator,
+            .source = .{ .buffer = .{ .tokens = tokens, .current = 0 } },
+            .prev = .{ .type = .eof, .start = 0 },
+            .tree = ast.Ast.init(),
+            .errors = diagnostics.DiagnosticList.init(allocator),
+        };
+    }
 
-    pub fn init(allocator: std.mem.Allocator, tokens: []Token) Self {
+    // Streaming mode: tokens are pulled from `stream` as the grammar needs
+    // them, so lexing and parsing overlap and no token array is ever built.
+    pub fn initStreaming(allocator: std.mem.Allocator, stream: *lexer.TokenStream) Self {
         return Self{
             .allocator = allocator,
-            .tokens = tokens,
-            .current = 0,
+            .source = .{ .stream = stream },
+            .prev = .{ .type = .eof, .start = 0 },
+            .tree = ast.Ast.init(),
+            .errors = diagnostics.DiagnosticList.init(allocator),
         };
     }
 
     pub fn deinit(self: *Self) void {
-        _ = self;
+        self.errors.deinit();
     }
 
-    pub fn parseProgram(self: *Self) !*ast.Node {
-        var statements = std.ArrayList(*ast.Node){};
+    pub fn parseProgram(self: *Self) !ast.Ast {
+        var statements = std.ArrayList(ast.NodeIndex){};
         defer statements.deinit(self.allocator);
 
         while (!self.isAtEnd()) {
             if (self.check(.eof)) break;
-            const stmt = try self.declaration();
-            try statements.append(self.allocator,stmt);
+            const stmt = self.declaration() catch |err| switch (err) {
+                ParseError.OutOfMemory => return err,
+                else => {
+                    self.synchronize();
+                    continue;
+                },
+            };
+            try statements.append(self.allocator, stmt);
+        }
+
+        const range = try self.tree.addExtra(self.allocator, statements.items);
+        self.tree.root = try self.addNode(.{
+            .node_type = .program,
+            .position = ast.Position{ .line = 1, .column = 1 },
+            .data = .{ .program = ast.Program{ .statements = range } },
+        });
+
+        if (self.errors.count() > 0) {
+            self.errors.flush(self.sourceBytes());
+            return ParseError.UnexpectedToken;
         }
+        return self.tree;
+    }
 
-        return ast.createProgram(self.allocator, try statements.toOwnedSlice(self.allocator));
+    // Panic-mode recovery: after an error, skip ahead to the next point a
+    // statement can begin. The unconditional first advance guarantees
+    // progress even when the offending token is itself a boundary.
+    fn synchronize(self: *Self) void {
+        self.advance();
+        while (!self.isAtEnd()) {
+            if (self.previousType() == .semicolon) return;
+            switch (self.peekType()) {
+                .fn_, .const_, .let_, .if_, .while_, .for_, .return_, .right_brace => return,
+                else => self.advance(),
+            }
+        }
     }
 
-    fn declaration(self: *Self) ParseError!*ast.Node {
+    fn declaration(self: *Self) ParseError!ast.NodeIndex {
         if (self.match(.fn_)) return self.functionDeclaration();
         if (self.match(.const_)) return self.variableDeclaration(false);
         if (self.match(.let_)) return self.variableDeclaration(true);
         return self.statement();
     }
 
-    fn functionDeclaration(self: *Self) ParseError!*ast.Node {
+    fn functionDeclaration(self: *Self) ParseError!ast.NodeIndex {
         const name_token = try self.consume(.identifier, "Expected function name");
-        const name = name_token.lexeme;
+        const name = self.lexemeOf(name_token);
+        const name_symbol = name_token.symbol;
 
         _ = try self.consume(.left_paren, "Expected '(' after function name");
 
@@ -69,8 +140,9 @@ pub const Parser = struct {
                 _ = try self.consume(.colon, "Expected ':' after parameter name");
                 const param_type = try self.parseType();
 
-                try parameters.append(self.allocator,ast.Parameter{
-                    .name = param_name_token.lexeme,
+                try parameters.append(self.allocator, ast.Parameter{
+                    .name = self.lexemeOf(param_name_token),
+                    .symbol = param_name_token.symbol,
                     .param_type = param_type,
                 });
 
@@ -85,17 +157,20 @@ pub const Parser = struct {
         _ = try self.consume(.left_brace, "Expected '{' before function body");
         const body = try self.blockStatement();
 
-        return ast.createFunctionDeclaration(
-            self.allocator,
-            getPosition(name_token),
-            name,
-            try parameters.toOwnedSlice(self.allocator),
-            return_type,
-            body,
-        );
+        return self.addNode(.{
+            .node_type = .function_declaration,
+            .position = self.positionOf(name_token),
+            .data = .{ .function_declaration = ast.FunctionDeclaration{
+                .name = name,
+                .symbol = name_symbol,
+                .parameters = try parameters.toOwnedSlice(self.allocator),
+                .return_type = return_type,
+                .body = body,
+            } },
+        });
     }
 
-    fn variableDeclaration(self: *Self, is_mutable: bool) ParseError!*ast.Node {
+    fn variableDeclaration(self: *Self, is_mutable: bool) ParseError!ast.NodeIndex {
         const name_token = try self.consume(.identifier, "Expected variable name");
 
         var var_type: ?types.Type = null;
@@ -103,69 +178,104 @@ pub const Parser = struct {
             var_type = try self.parseType();
         }
 
-        var initializer: ?*ast.Node = null;
+        var initializer: ast.NodeIndex = ast.null_node;
         if (self.match(.equal)) {
             initializer = try self.expression();
         }
 
         _ = try self.consume(.semicolon, "Expected ';' after variable declaration");
 
-        const node = try ast.createNode(self.allocator, .variable_declaration, getPosition(name_token));
-        node.data = .{ .variable_declaration = ast.VariableDeclaration{
-            .name = name_token.lexeme,
-            .var_type = var_type,
-            .is_mutable = is_mutable,
-            .initializer = initializer,
-        } };
-        return node;
+        return self.addNode(.{
+            .node_type = .variable_declaration,
+            .position = self.positionOf(name_token),
+            .data = .{ .variable_declaration = ast.VariableDeclaration{
+                .name = self.lexemeOf(name_token),
+                .symbol = name_token.symbol,
+                .var_type = var_type,
+                .is_mutable = is_mutable,
+                .initializer = initializer,
+            } },
+        });
     }
 
-    fn statement(self: *Self) ParseError!*ast.Node {
+    fn statement(self: *Self) ParseError!ast.NodeIndex {
         if (self.match(.if_)) return self.ifStatement();
         if (self.match(.while_)) return self.whileStatement();
+        if (self.match(.for_)) return self.forStatement();
         if (self.match(.return_)) return self.returnStatement();
         if (self.match(.left_brace)) return self.blockStatement();
         return self.expressionStatement();
     }
 
-    fn ifStatement(self: *Self) ParseError!*ast.Node {
+    fn ifStatement(self: *Self) ParseError!ast.NodeIndex {
         _ = try self.consume(.left_paren, "Expected '(' after 'if'");
         const condition = try self.expression();
         _ = try self.consume(.right_paren, "Expected ')' after if condition");
 
         const then_branch = try self.statement();
-        var else_branch: ?*ast.Node = null;
+        var else_branch: ast.NodeIndex = ast.null_node;
         if (self.match(.else_)) {
             else_branch = try self.statement();
         }
 
-        const node = try ast.createNode(self.allocator, .if_statement, getPosition(self.previous()));
-        node.data = .{ .if_statement = ast.IfStatement{
-            .condition = condition,
-            .then_branch = then_branch,
-            .else_branch = else_branch,
-        } };
-        return node;
+        return self.addNode(.{
+            .node_type = .if_statement,
+            .position = self.previousPosition(),
+            .data = .{ .if_statement = ast.IfStatement{
+                .condition = condition,
+                .then_branch = then_branch,
+                .else_branch = else_branch,
+            } },
+        });
     }
 
-    fn whileStatement(self: *Self) ParseError!*ast.Node {
+    fn whileStatement(self: *Self) ParseError!ast.NodeIndex {
         _ = try self.consume(.left_paren, "Expected '(' after 'while'");
         const condition = try self.expression();
         _ = try self.consume(.right_paren, "Expected ')' after while condition");
 
         const body = try self.statement();
 
-        const node = try ast.createNode(self.allocator, .while_statement, getPosition(self.previous()));
-        node.data = .{ .while_statement = ast.WhileStatement{
-            .condition = condition,
-            .body = body,
-        } };
-        return node;
+        return self.addNode(.{
+            .node_type = .while_statement,
+            .position = self.previousPosition(),
+            .data = .{ .while_statement = ast.WhileStatement{
+                .condition = condition,
+                .body = body,
+            } },
+        });
+    }
+
+    // `for i in start..end { ... }`. The body is always a block; the
+    // range bounds are full expressions, with `..` sitting above them the
+    // way `=` sits above an initializer.
+    fn forStatement(self: *Self) ParseError!ast.NodeIndex {
+        const name_token = try self.consume(.identifier, "Expected loop variable after 'for'");
+        _ = try self.consume(.in_, "Expected 'in' after loop variable");
+
+        const start = try self.expression();
+        _ = try self.consume(.dot_dot, "Expected '..' between range bounds");
+        const end = try self.expression();
+
+        _ = try self.consume(.left_brace, "Expected '{' before for body");
+        const body = try self.blockStatement();
+
+        return self.addNode(.{
+            .node_type = .for_statement,
+            .position = self.positionOf(name_token),
+            .data = .{ .for_statement = ast.ForStatement{
+                .name = self.lexemeOf(name_token),
+                .symbol = name_token.symbol,
+                .start = start,
+                .end = end,
+                .body = body,
+            } },
+        });
     }
 
-    fn returnStatement(self: *Self) ParseError!*ast.Node {
-        const keyword = self.previous();
-        var value: ?*ast.Node = null;
+    fn returnStatement(self: *Self) ParseError!ast.NodeIndex {
+        const keyword = self.prev;
+        var value: ast.NodeIndex = ast.null_node;
 
         if (!self.check(.semicolon)) {
             value = try self.expression();
@@ -173,108 +283,111 @@ pub const Parser = struct {
 
         _ = try self.consume(.semicolon, "Expected ';' after return value");
 
-        const node = try ast.createNode(self.allocator, .return_statement, getPosition(keyword));
-        node.data = .{ .return_statement = ast.ReturnStatement{ .value = value } };
-        return node;
+        return self.addNode(.{
+            .node_type = .return_statement,
+            .position = self.positionOf(keyword),
+            .data = .{ .return_statement = ast.ReturnStatement{ .value = value } },
+        });
     }
 
-    fn blockStatement(self: *Self) ParseError!*ast.Node {
-        var statements = std.ArrayList(*ast.Node){};
+    fn blockStatement(self: *Self) ParseError!ast.NodeIndex {
+        var statements = std.ArrayList(ast.NodeIndex){};
         defer statements.deinit(self.allocator);
 
         while (!self.check(.right_brace) and !self.isAtEnd()) {
-            try statements.append(self.allocator,try self.declaration());
+            const stmt = self.declaration() catch |err| switch (err) {
+                ParseError.OutOfMemory => return err,
+                else => {
+                    self.synchronize();
+                    continue;
+                },
+            };
+            try statements.append(self.allocator, stmt);
         }
 
         _ = try self.consume(.right_brace, "Expected '}' after block");
 
-        const node = try ast.createNode(self.allocator, .block_statement, getPosition(self.previous()));
-        node.data = .{ .block_statement = ast.BlockStatement{
-            .statements = try statements.toOwnedSlice(self.allocator),
-        } };
-        return node;
+        const range = try self.tree.addExtra(self.allocator, statements.items);
+        return self.addNode(.{
+            .node_type = .block_statement,
+            .position = self.previousPosition(),
+            .data = .{ .block_statement = ast.BlockStatement{ .statements = range } },
+        });
     }
 
-    fn expressionStatement(self: *Self) ParseError!*ast.Node {
+    fn expressionStatement(self: *Self) ParseError!ast.NodeIndex {
         const expr = try self.expression();
         _ = try self.consume(.semicolon, "Expected ';' after expression");
 
-        const node = try ast.createNode(self.allocator, .expression_statement, getPosition(self.previous()));
-        node.data = .{ .expression_statement = ast.ExpressionStatement{ .expression = expr } };
-        return node;
+        return self.addNode(.{
+            .node_type = .expression_statement,
+            .position = self.previousPosition(),
+            .data = .{ .expression_statement = ast.ExpressionStatement{ .expression = expr } },
+        });
     }
 
-    fn expression(self: *Self) ParseError!*ast.Node {
+    fn expression(self: *Self) ParseError!ast.NodeIndex {
         return self.assignment();
     }
 
-    fn assignment(self: *Self) ParseError!*ast.Node {
+    fn assignment(self: *Self) ParseError!ast.NodeIndex {
         const expr = try self.logicalOr();
 
         if (self.match(.equal)) {
             const value = try self.assignment();
-            if (expr.node_type == .identifier) {
-                const node = try ast.createNode(self.allocator, .assignment_expression, getPosition(self.previous()));
-                node.data = .{ .assignment_expression = ast.AssignmentExpression{
-                    .target = expr,
-                    .value = value,
-                } };
-                return node;
+            if (self.tree.nodeAt(expr).node_type == .identifier) {
+                return self.addNode(.{
+                    .node_type = .assignment_expression,
+                    .position = self.previousPosition(),
+                    .data = .{ .assignment_expression = ast.AssignmentExpression{
+                        .target = expr,
+                        .value = value,
+                    } },
+                });
             }
+            self.reportError("Invalid assignment target", .{});
             return ParseError.ExpectedExpression;
         }
 
         return expr;
     }
 
-    fn logicalOr(self: *Self) ParseError!*ast.Node {
+    fn logicalOr(self: *Self) ParseError!ast.NodeIndex {
         var expr = try self.logicalAnd();
 
         while (self.match(.equal_equal)) { // Using == as OR for now, add proper || later
             const operator: ast.BinaryOperator = .logical_or;
             const right = try self.logicalAnd();
-            const node = try ast.createNode(self.allocator, .binary_expression, getPosition(self.previous()));
-            node.data = .{ .binary_expression = ast.BinaryExpression{
-                .left = expr,
-                .operator = operator,
-                .right = right,
-            } };
-            expr = node;
+            expr = try self.binaryNode(expr, operator, right);
         }
 
         return expr;
     }
 
-    fn logicalAnd(self: *Self) ParseError!*ast.Node {
+    fn logicalAnd(self: *Self) ParseError!ast.NodeIndex {
         const expr = try self.equality();
 
         // Add && support later
         return expr;
     }
 
-    fn equality(self: *Self) ParseError!*ast.Node {
+    fn equality(self: *Self) ParseError!ast.NodeIndex {
         var expr = try self.comparison();
 
         while (self.match(.bang_equal) or self.match(.equal_equal)) {
-            const operator: ast.BinaryOperator = if (self.previous().type == .bang_equal) .not_equal else .equal;
+            const operator: ast.BinaryOperator = if (self.previousType() == .bang_equal) .not_equal else .equal;
             const right = try self.comparison();
-            const node = try ast.createNode(self.allocator, .binary_expression, getPosition(self.previous()));
-            node.data = .{ .binary_expression = ast.BinaryExpression{
-                .left = expr,
-                .operator = operator,
-                .right = right,
-            } };
-            expr = node;
+            expr = try self.binaryNode(expr, operator, right);
         }
 
         return expr;
     }
 
-    fn comparison(self: *Self) ParseError!*ast.Node {
+    fn comparison(self: *Self) ParseError!ast.NodeIndex {
         var expr = try self.term();
 
         while (self.match(.greater) or self.match(.greater_equal) or self.match(.less) or self.match(.less_equal)) {
-            const operator: ast.BinaryOperator = switch (self.previous().type) {
+            const operator: ast.BinaryOperator = switch (self.previousType()) {
                 .greater => .greater_than,
                 .greater_equal => .greater_equal,
                 .less => .less_than,
@@ -282,70 +395,66 @@ pub const Parser = struct {
                 else => unreachable,
             };
             const right = try self.term();
-            const node = try ast.createNode(self.allocator, .binary_expression, getPosition(self.previous()));
-            node.data = .{ .binary_expression = ast.BinaryExpression{
-                .left = expr,
-                .operator = operator,
-                .right = right,
-            } };
-            expr = node;
+            expr = try self.binaryNode(expr, operator, right);
         }
 
         return expr;
     }
 
-    fn term(self: *Self) ParseError!*ast.Node {
+    fn term(self: *Self) ParseError!ast.NodeIndex {
         var expr = try self.factor();
 
         while (self.match(.minus) or self.match(.plus)) {
-            const operator: ast.BinaryOperator = if (self.previous().type == .minus) .subtract else .add;
+            const operator: ast.BinaryOperator = if (self.previousType() == .minus) .subtract else .add;
             const right = try self.factor();
-            const node = try ast.createNode(self.allocator, .binary_expression, getPosition(self.previous()));
-            node.data = .{ .binary_expression = ast.BinaryExpression{
-                .left = expr,
-                .operator = operator,
-                .right = right,
-            } };
-            expr = node;
+            expr = try self.binaryNode(expr, operator, right);
         }
 
         return expr;
     }
 
-    fn factor(self: *Self) ParseError!*ast.Node {
+    fn factor(self: *Self) ParseError!ast.NodeIndex {
         var expr = try self.unary();
 
         while (self.match(.slash) or self.match(.star)) {
-            const operator: ast.BinaryOperator = if (self.previous().type == .slash) .divide else .multiply;
+            const operator: ast.BinaryOperator = if (self.previousType() == .slash) .divide else .multiply;
             const right = try self.unary();
-            const node = try ast.createNode(self.allocator, .binary_expression, getPosition(self.previous()));
-            node.data = .{ .binary_expression = ast.BinaryExpression{
-                .left = expr,
-                .operator = operator,
-                .right = right,
-            } };
-            expr = node;
+            expr = try self.binaryNode(expr, operator, right);
         }
 
         return expr;
     }
 
-    fn unary(self: *Self) ParseError!*ast.Node {
+    fn binaryNode(self: *Self, left: ast.NodeIndex, operator: ast.BinaryOperator, right: ast.NodeIndex) ParseError!ast.NodeIndex {
+        return self.addNode(.{
+            .node_type = .binary_expression,
+            .position = self.previousPosition(),
+            .data = .{ .binary_expression = ast.BinaryExpression{
+                .left = left,
+                .operator = operator,
+                .right = right,
+            } },
+        });
+    }
+
+    fn unary(self: *Self) ParseError!ast.NodeIndex {
         if (self.match(.bang) or self.match(.minus)) {
-            const operator: ast.UnaryOperator = if (self.previous().type == .bang) .logical_not else .minus;
+            const operator: ast.UnaryOperator = if (self.previousType() == .bang) .logical_not else .minus;
             const right = try self.unary();
-            const node = try ast.createNode(self.allocator, .unary_expression, getPosition(self.previous()));
-            node.data = .{ .unary_expression = ast.UnaryExpression{
-                .operator = operator,
-                .operand = right,
-            } };
-            return node;
+            return self.addNode(.{
+                .node_type = .unary_expression,
+                .position = self.previousPosition(),
+                .data = .{ .unary_expression = ast.UnaryExpression{
+                    .operator = operator,
+                    .operand = right,
+                } },
+            });
         }
 
         return self.call();
     }
 
-    fn call(self: *Self) ParseError!*ast.Node {
+    fn call(self: *Self) ParseError!ast.NodeIndex {
         var expr = try self.primary();
 
         while (true) {
@@ -359,55 +468,75 @@ pub const Parser = struct {
         return expr;
     }
 
-    fn finishCall(self: *Self, callee: *ast.Node) ParseError!*ast.Node {
-        var arguments = std.ArrayList(*ast.Node){};
+    fn finishCall(self: *Self, callee: ast.NodeIndex) ParseError!ast.NodeIndex {
+        var arguments = std.ArrayList(ast.NodeIndex){};
         defer arguments.deinit(self.allocator);
 
         if (!self.check(.right_paren)) {
             while (true) {
-                try arguments.append(self.allocator,try self.expression());
+                try arguments.append(self.allocator, try self.expression());
                 if (!self.match(.comma)) break;
             }
         }
 
         _ = try self.consume(.right_paren, "Expected ')' after arguments");
 
-        const node = try ast.createNode(self.allocator, .call_expression, getPosition(self.previous()));
-        node.data = .{ .call_expression = ast.CallExpression{
-            .function = callee,
-            .arguments = try arguments.toOwnedSlice(self.allocator),
-        } };
-        return node;
+        const range = try self.tree.addExtra(self.allocator, arguments.items);
+        return self.addNode(.{
+            .node_type = .call_expression,
+            .position = self.previousPosition(),
+            .data = .{ .call_expression = ast.CallExpression{
+                .function = callee,
+                .arguments = range,
+            } },
+        });
     }
 
-    fn primary(self: *Self) ParseError!*ast.Node {
+    fn primary(self: *Self) ParseError!ast.NodeIndex {
         if (self.match(.false_)) {
-            const node = try ast.createNode(self.allocator, .boolean_literal, getPosition(self.previous()));
-            node.data = .{ .boolean_literal = ast.BooleanLiteral{ .value = false } };
-            return node;
+            return self.addNode(.{
+                .node_type = .boolean_literal,
+                .position = self.previousPosition(),
+                .data = .{ .boolean_literal = ast.BooleanLiteral{ .value = false } },
+            });
         }
 
         if (self.match(.true_)) {
-            const node = try ast.createNode(self.allocator, .boolean_literal, getPosition(self.previous()));
-            node.data = .{ .boolean_literal = ast.BooleanLiteral{ .value = true } };
-            return node;
+            return self.addNode(.{
+                .node_type = .boolean_literal,
+                .position = self.previousPosition(),
+                .data = .{ .boolean_literal = ast.BooleanLiteral{ .value = true } },
+            });
         }
 
         if (self.match(.number)) {
-            const lexeme = self.previous().lexeme;
+            const lexeme = self.previousLexeme();
             const value = std.fmt.parseFloat(f64, lexeme) catch return ParseError.ExpectedExpression;
             const is_integer = std.mem.indexOf(u8, lexeme, ".") == null;
-            return ast.createNumberLiteral(self.allocator, getPosition(self.previous()), value, is_integer);
+            return self.addNode(.{
+                .node_type = .number_literal,
+                .position = self.previousPosition(),
+                .data = .{ .number_literal = ast.NumberLiteral{ .value = value, .is_integer = is_integer } },
+            });
         }
 
         if (self.match(.string_literal)) {
-            const node = try ast.createNode(self.allocator, .string_literal, getPosition(self.previous()));
-            node.data = .{ .string_literal = ast.StringLiteral{ .value = self.previous().lexeme } };
-            return node;
+            return self.addNode(.{
+                .node_type = .string_literal,
+                .position = self.previousPosition(),
+                .data = .{ .string_literal = ast.StringLiteral{ .value = self.previousLexeme() } },
+            });
         }
 
         if (self.match(.identifier)) {
-            return ast.createIdentifier(self.allocator, getPosition(self.previous()), self.previous().lexeme);
+            return self.addNode(.{
+                .node_type = .identifier,
+                .position = self.previousPosition(),
+                .data = .{ .identifier = ast.Identifier{
+                    .name = self.previousLexeme(),
+                    .symbol = self.prev.symbol,
+                } },
+            });
         }
 
         if (self.match(.left_paren)) {
@@ -416,6 +545,7 @@ pub const Parser = struct {
             return expr;
         }
 
+        self.reportError("Expected expression at '{s}'", .{self.lexemeOf(self.peekToken())});
         return ParseError.ExpectedExpression;
     }
 
@@ -425,13 +555,20 @@ pub const Parser = struct {
         if (self.match(.f64)) return .f64;
         if (self.match(.bool)) return .bool;
         if (self.match(.string)) return .string;
+        self.reportError("Expected type name at '{s}'", .{self.lexemeOf(self.peekToken())});
         return ParseError.ExpectedType;
     }
 
-    // Utility methods
+    fn addNode(self: *Self, node: ast.Node) ParseError!ast.NodeIndex {
+        return self.tree.addNode(self.allocator, node);
+    }
+
+    // Utility methods. The parser only ever touches token types on the hot
+    // path; lexemes and positions are recomputed from the token's start
+    // offset when a node or diagnostic actually needs them.
     fn match(self: *Self, token_type: TokenType) bool {
         if (self.check(token_type)) {
-            _ = self.advance();
+            self.advance();
             return true;
         }
         return false;
@@ -439,47 +576,96 @@ pub const Parser = struct {
 
     fn check(self: *Self, token_type: TokenType) bool {
         if (self.isAtEnd()) return false;
-        return self.peek().type == token_type;
+        return self.peekType() == token_type;
+    }
+
+    fn advance(self: *Self) void {
+        switch (self.source) {
+            .buffer => |*b| {
+                self.prev = .{
+                    .type = b.tokens.types[b.current],
+                    .start = b.tokens.starts[b.current],
+                    .symbol = b.tokens.symbols[b.current],
+                };
+                if (self.prev.type != .eof) b.current += 1;
+            },
+            .stream => |s| {
+                self.prev = s.advance() catch self.errorToken();
+            },
+        }
     }
 
-    fn advance(self: *Self) Token {
-        if (!self.isAtEnd()) self.current += 1;
-        return self.previous();
+    fn isAtEnd(self: *Self) bool {
+        return self.peekType() == .eof;
     }
 
-    fn isAtEnd(self: *Self) bool {
-        return self.peek().type == .eof;
+    fn peekToken(self: *Self) lexer.StreamedToken {
+        switch (self.source) {
+            .buffer => |*b| return .{
+                .type = b.tokens.types[b.current],
+                .start = b.tokens.starts[b.current],
+                .symbol = b.tokens.symbols[b.current],
+            },
+            .stream => |s| return s.peek(0) catch self.errorToken(),
+        }
     }
 
-    fn peek(self: *Self) Token {
-        return self.tokens[self.current];
+    fn peekType(self: *Self) TokenType {
+        return self.peekToken().type;
     }
 
-    fn previous(self: *Self) Token {
-        return self.tokens[self.current - 1];
+    fn errorToken(self: *Self) lexer.StreamedToken {
+        return .{ .type = .error_, .start = @intCast(self.sourceBytes().len) };
     }
 
-    fn consume(self: *Self, token_type: TokenType, message: []const u8) ParseError!Token {
-        if (self.check(token_type)) return self.advance();
+    fn previousType(self: *Self) TokenType {
+        return self.prev.type;
+    }
 
-        std.debug.print("Parse error: {s} at token '{s}'\n", .{ message, self.peek().lexeme });
-        return ParseError.UnexpectedToken;
+    fn previousLexeme(self: *Self) []const u8 {
+        return self.lexemeOf(self.prev);
     }
-};
 
-// Token helper method
-fn tokenGetPosition(token: Token) ast.Position {
-    return ast.Position{ .line = token.line, .column = token.column };
-}
+    fn previousPosition(self: *Self) ast.Position {
+        return self.positionOf(self.prev);
+    }
 
-// Add method to Token type (this is a workaround since we can't extend the Token struct directly)
-const TokenExtensions = struct {
-    fn getPosition(token: Token) ast.Position {
-        return ast.Position{ .line = token.line, .column = token.column };
+    fn lexemeOf(self: *Self, token: lexer.StreamedToken) []const u8 {
+        return lexer.lexemeFrom(self.sourceBytes(), token.type, token.start);
     }
-};
 
-// Make the extension available
-pub fn getPosition(token: Token) ast.Position {
-    return TokenExtensions.getPosition(token);
-}
+    fn positionOf(self: *Self, token: lexer.StreamedToken) ast.Position {
+        const pos = lexer.lineColFrom(self.lineStarts(), token.start);
+        return ast.Position{ .line = pos.line, .column = pos.column };
+    }
+
+    fn sourceBytes(self: *Self) []const u8 {
+        return switch (self.source) {
+            .buffer => |*b| b.tokens.source,
+            .stream => |s| s.source(),
+        };
+    }
+
+    fn lineStarts(self: *Self) []const u32 {
+        return switch (self.source) {
+            .buffer => |*b| b.tokens.line_starts,
+            .stream => |s| s.lineStarts(),
+        };
+    }
+
+    fn consume(self: *Self, token_type: TokenType, message: []const u8) ParseError!lexer.StreamedToken {
+        if (self.check(token_type)) {
+            self.advance();
+            return self.prev;
+        }
+
+        self.reportError("{s} at '{s}'", .{ message, self.lexemeOf(self.peekToken()) });
+        return ParseError.UnexpectedToken;
+    }
+
+    // Record a diagnostic at the current token; the caller still returns
+    // its parse error, and the nearest statement loop synchronizes.
+    fn reportError(self: *Self, comptime fmt: []const u8, args: anytype) void {
+        self.errors.add(self.positionOf(self.peekToken()), fmt, args) catch {};
+    }
+};
@@ -5,7 +5,12 @@ pub const lexer = @import("lexer.zig");
 pub const parser = @import("parser.zig");
 pub const ast = @import("ast.zig");
 pub const types = @import("types.zig");
+pub const intern = @import("intern.zig");
+pub const cache = @import("cache.zig");
+pub const astcache = @import("astcache.zig");
 pub const checker = @import("checker.zig");
+pub const fold = @import("fold.zig");
+pub const diagnostics = @import("diagnostics.zig");
 pub const codegen = @import("codegen.zig");
 
 pub fn version() []const u8 {
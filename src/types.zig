@@ -1,4 +1,5 @@
 const std = @import("std");
+const intern = @import("intern.zig");
 
 pub const Type = enum {
     void,
@@ -67,74 +68,124 @@ pub const TypeError = error{
     OutOfMemory,
 };
 
-// Type environment for tracking variable types
+// Type environment for tracking variable types. Keyed by interned symbol
+// IDs rather than name strings, so the per-statement lookups in the checker
+// compare u32s instead of identifier spellings.
 pub const TypeEnvironment = struct {
     const Self = @This();
 
+    pub const VariableBinding = struct {
+        symbol: intern.Symbol,
+        var_type: Type,
+        // `let` vs `const`: assignment to an immutable binding is a type
+        // error, which is also what lets the folder propagate const values
+        // and codegen keep them as bare SSA values.
+        is_mutable: bool,
+    };
+
     allocator: std.mem.Allocator,
-    variables: std.StringHashMap(Type),
-    functions: std.StringHashMap(FunctionType),
+    // Lexical scopes as one flat binding array plus per-scope watermarks:
+    // pushScope records the current length and popScope truncates back to
+    // it, so entering and leaving a scope is O(1) and defining a variable
+    // is an append instead of a hashmap insert. Lookup scans backwards,
+    // which also gives inner bindings shadowing outer ones for free.
+    variables: std.ArrayList(VariableBinding),
+    scope_marks: std.ArrayList(u32),
+    functions: std.AutoHashMap(intern.Symbol, FunctionType),
+    // Read-only signature table consulted after the local one. Parallel
+    // checking gives every worker its own environment backed by the fully
+    // collected function table of the main checker, which no one mutates
+    // while workers are running.
+    shared_functions: ?*const std.AutoHashMap(intern.Symbol, FunctionType),
 
     pub fn init(allocator: std.mem.Allocator) Self {
         return Self{
             .allocator = allocator,
-            .variables = std.StringHashMap(Type).init(allocator),
-            .functions = std.StringHashMap(FunctionType).init(allocator),
+            .variables = std.ArrayList(VariableBinding){},
+            .scope_marks = std.ArrayList(u32){},
+            .functions = std.AutoHashMap(intern.Symbol, FunctionType).init(allocator),
+            .shared_functions = null,
         };
     }
 
     pub fn deinit(self: *Self) void {
-        self.variables.deinit();
+        self.variables.deinit(self.allocator);
+        self.scope_marks.deinit(self.allocator);
         self.functions.deinit();
     }
 
-    pub fn defineVariable(self: *Self, name: []const u8, var_type: Type) !void {
-        try self.variables.put(name, var_type);
+    pub fn pushScope(self: *Self) !void {
+        try self.scope_marks.append(self.allocator, @intCast(self.variables.items.len));
+    }
+
+    pub fn popScope(self: *Self) void {
+        const mark = self.scope_marks.pop().?;
+        self.variables.shrinkRetainingCapacity(mark);
+    }
+
+    pub fn defineVariable(self: *Self, symbol: intern.Symbol, var_type: Type, is_mutable: bool) !void {
+        try self.variables.append(self.allocator, .{ .symbol = symbol, .var_type = var_type, .is_mutable = is_mutable });
+    }
+
+    pub fn lookupVariable(self: *Self, symbol: intern.Symbol) ?Type {
+        const binding = self.lookupBinding(symbol) orelse return null;
+        return binding.var_type;
     }
 
-    pub fn lookupVariable(self: *Self, name: []const u8) ?Type {
-        return self.variables.get(name);
+    pub fn lookupBinding(self: *Self, symbol: intern.Symbol) ?VariableBinding {
+        var i = self.variables.items.len;
+        while (i > 0) {
+            i -= 1;
+            const binding = self.variables.items[i];
+            if (binding.symbol == symbol) return binding;
+        }
+        return null;
     }
 
-    pub fn defineFunction(self: *Self, name: []const u8, func_type: FunctionType) !void {
-        try self.functions.put(name, func_type);
+    pub fn defineFunction(self: *Self, symbol: intern.Symbol, func_type: FunctionType) !void {
+        try self.functions.put(symbol, func_type);
     }
 
-    pub fn lookupFunction(self: *Self, name: []const u8) ?FunctionType {
-        return self.functions.get(name);
+    pub fn lookupFunction(self: *Self, symbol: intern.Symbol) ?FunctionType {
+        if (self.functions.get(symbol)) |func_type| return func_type;
+        if (self.shared_functions) |shared| return shared.get(symbol);
+        return null;
     }
 };
 
 pub const FunctionType = struct {
-    parameters: []Type,
+    parameters: []const Type,
     return_type: Type,
 };
 
-// Built-in function types
-pub fn getBuiltinFunctions(allocator: std.mem.Allocator) !std.StringHashMap(FunctionType) {
-    var builtins = std.StringHashMap(FunctionType).init(allocator);
-
-    // print(string) -> void
-    const print_params = try allocator.dupe(Type, &[_]Type{.string});
-    try builtins.put("print", FunctionType{
-        .parameters = print_params,
-        .return_type = .void,
-    });
-
-    // print_int(i32) -> void
-    const print_int_params = try allocator.dupe(Type, &[_]Type{.i32});
-    try builtins.put("print_int", FunctionType{
-        .parameters = print_int_params,
-        .return_type = .void,
-    });
-
-    return builtins;
-}
+// Built-in functions, as one comptime table shared by the checker and the
+// code generator. The data never changes, so nothing is allocated or torn
+// down per compile; the checker consults the table directly and codegen
+// derives both the wrapper signature and the printf format from it.
+pub const Builtin = struct {
+    name: [:0]const u8,
+    func_type: FunctionType,
+    // Symbol the codegen resolves calls to: the buffered writer in the
+    // Zen runtime (src/zen_runtime.c) with the same signature.
+    runtime_symbol: [:0]const u8,
+};
+
+pub const builtin_functions = [_]Builtin{
+    .{
+        .name = "print",
+        .func_type = .{ .parameters = &.{.string}, .return_type = .void },
+        .runtime_symbol = "zen_print",
+    },
+    .{
+        .name = "print_int",
+        .func_type = .{ .parameters = &.{.i32}, .return_type = .void },
+        .runtime_symbol = "zen_print_int",
+    },
+};
 
-pub fn deinitBuiltinFunctions(allocator: std.mem.Allocator, builtins: *std.StringHashMap(FunctionType)) void {
-    var iterator = builtins.iterator();
-    while (iterator.next()) |entry| {
-        allocator.free(entry.value_ptr.parameters);
+pub fn lookupBuiltin(name: []const u8) ?FunctionType {
+    inline for (builtin_functions) |builtin| {
+        if (std.mem.eql(u8, name, builtin.name)) return builtin.func_type;
     }
-    builtins.deinit();
+    return null;
 }
@@ -0,0 +1,80 @@
+/*
+ * Zen runtime: buffered writers for the print builtins.
+ *
+ * The compiler used to lower print/print_int to one printf call per
+ * invocation, so output-heavy programs paid a format-string parse and
+ * line-granularity flushing for every line. Output now accumulates in a
+ * 64KB user-space buffer and leaves the process in full write(2) calls;
+ * the remainder is flushed by an atexit handler registered on first use.
+ *
+ * This file travels embedded in the zenc binary and is handed to cc
+ * during `zenc build`, so generated objects resolve zen_print and
+ * zen_print_int without any install step.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define ZEN_OUT_CAP 65536
+
+static char zen_out_buf[ZEN_OUT_CAP];
+static size_t zen_out_len = 0;
+static int zen_flush_registered = 0;
+
+static void zen_flush(void) {
+    size_t off = 0;
+    while (off < zen_out_len) {
+        ssize_t n = write(1, zen_out_buf + off, zen_out_len - off);
+        if (n <= 0)
+            break;
+        off += (size_t)n;
+    }
+    zen_out_len = 0;
+}
+
+static void zen_append(const char *data, size_t len) {
+    if (!zen_flush_registered) {
+        atexit(zen_flush);
+        zen_flush_registered = 1;
+    }
+    if (len >= ZEN_OUT_CAP) {
+        /* Oversized payloads bypass the buffer after draining it, so
+         * output order is preserved. */
+        zen_flush();
+        size_t off = 0;
+        while (off < len) {
+            ssize_t n = write(1, data + off, len - off);
+            if (n <= 0)
+                return;
+            off += (size_t)n;
+        }
+        return;
+    }
+    if (zen_out_len + len > ZEN_OUT_CAP)
+        zen_flush();
+    memcpy(zen_out_buf + zen_out_len, data, len);
+    zen_out_len += len;
+}
+
+void zen_print(const char *s) {
+    zen_append(s, strlen(s));
+    zen_append("\n", 1);
+}
+
+void zen_print_int(int value) {
+    /* Hand-rolled formatting; no printf machinery on the output path. */
+    char tmp[16];
+    char *end = tmp + sizeof(tmp);
+    char *p = end;
+    unsigned int magnitude = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+
+    *--p = '\n';
+    do {
+        *--p = (char)('0' + magnitude % 10u);
+        magnitude /= 10u;
+    } while (magnitude != 0);
+    if (value < 0)
+        *--p = '-';
+
+    zen_append(p, (size_t)(end - p));
+}